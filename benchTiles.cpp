@@ -0,0 +1,234 @@
+// Writes the local TMS tile sets of bench.earth: procedural imagery and
+// elevation in the global-geodetic profile, the whole globe down to
+// BENCH_GLOBAL_LEVEL and a few tiles around each flight viewpoint down to
+// BENCH_MAX_LEVEL. Deterministic, so runs on different hosts page the same
+// data.
+
+#include "vps.h"
+
+#include <osg/Image>
+#include <osgDB/FileUtils>
+#include <osgDB/WriteFile>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+#define BENCH_GLOBAL_LEVEL 4
+#define BENCH_MAX_LEVEL 13
+#define BENCH_TILES_AROUND 3 // tiles on each side of a viewpoint per level
+
+#define IMAGE_SIZE 256
+#define ELEVATION_SIZE 32
+
+struct Tile
+{
+    uint32_t level, x, y; // y counts from the south as in TMS
+
+    bool operator < ( const Tile& rhs ) const
+    {
+        if( level != rhs.level )
+            return level < rhs.level;
+        return ( y != rhs.y ) ? y < rhs.y : x < rhs.x;
+    }
+};
+
+// Rolling terrain with detail down to a few hundred meters, in meters
+static float elevation( const double lon, const double lat )
+{
+    const double x = osg::DegreesToRadians( lon );
+    const double y = osg::DegreesToRadians( lat );
+
+    double h = 0., amplitude = 3000., frequency = 3.;
+    for( uint32_t octave = 0; octave < 12; ++octave )
+    {
+        h += amplitude * sin( frequency * x + octave ) *
+            cos( frequency * y + 0.7 * octave );
+        amplitude *= 0.5;
+        frequency *= 2.1;
+    }
+    return static_cast< float >( h );
+}
+
+static double tileSize( const uint32_t level )
+{
+    return 180. / ( 1 << level );
+}
+
+static void writeImage( const std::string& dir, const Tile& tile )
+{
+    const double size = tileSize( tile.level );
+    const double west = -180. + tile.x * size;
+    const double south = -90. + tile.y * size;
+
+    osg::ref_ptr< osg::Image > image = new osg::Image;
+    image->allocateImage( IMAGE_SIZE, IMAGE_SIZE, 1, GL_RGB,
+        GL_UNSIGNED_BYTE );
+
+    // rows from the south, as osg::Image stores them
+    for( uint32_t t = 0; t < IMAGE_SIZE; ++t )
+    {
+        const double lat = south + ( t + .5 ) * size / IMAGE_SIZE;
+        for( uint32_t s = 0; s < IMAGE_SIZE; ++s )
+        {
+            const double lon = west + ( s + .5 ) * size / IMAGE_SIZE;
+            const float h = elevation( lon, lat );
+
+            unsigned char* rgb = image->data( s, t );
+            if( h < 0.f ) // water
+            {
+                rgb[0] = 20;
+                rgb[1] = 60;
+                rgb[2] = static_cast< unsigned char >(
+                    140.f + std::max( h / 50.f, -100.f ));
+            }
+            else
+            {
+                const float f = std::min( h / 4000.f, 1.f );
+                rgb[0] = static_cast< unsigned char >( 60 + 170 * f );
+                rgb[1] = static_cast< unsigned char >( 130 + 80 * f );
+                rgb[2] = static_cast< unsigned char >( 50 + 180 * f );
+            }
+        }
+    }
+
+    std::ostringstream name;
+    name << dir << "/imagery/" << tile.level << "/" << tile.x << "/"
+        << tile.y << ".jpg";
+    osgDB::makeDirectoryForFile( name.str( ));
+    osgDB::writeImageFile( *image, name.str( ));
+}
+
+static void writeElevation( const std::string& dir, const Tile& tile )
+{
+    const double size = tileSize( tile.level );
+    const double west = -180. + tile.x * size;
+    const double south = -90. + tile.y * size;
+
+    osg::ref_ptr< osg::Image > image = new osg::Image;
+    image->allocateImage( ELEVATION_SIZE, ELEVATION_SIZE, 1, GL_LUMINANCE,
+        GL_FLOAT );
+
+    // posts on the tile edges, shared with the neighbors
+    for( uint32_t t = 0; t < ELEVATION_SIZE; ++t )
+    {
+        const double lat = south + t * size / ( ELEVATION_SIZE - 1 );
+        for( uint32_t s = 0; s < ELEVATION_SIZE; ++s )
+        {
+            const double lon = west + s * size / ( ELEVATION_SIZE - 1 );
+            *reinterpret_cast< float* >( image->data( s, t )) =
+                elevation( lon, lat );
+        }
+    }
+
+    std::ostringstream name;
+    name << dir << "/elevation/" << tile.level << "/" << tile.x << "/"
+        << tile.y << ".tif";
+    osgDB::makeDirectoryForFile( name.str( ));
+    osgDB::writeImageFile( *image, name.str( ));
+}
+
+static bool writeTileMap( const std::string& fileName, const char* title,
+        const uint32_t size, const char* mimeType, const char* extension )
+{
+    osgDB::makeDirectoryForFile( fileName );
+    std::ofstream file( fileName.c_str( ));
+    file << "<?xml version=\"1.0\"?>" << std::endl
+        << "<TileMap version=\"1.0.0\""
+        << " tilemapservice=\"http://tms.osgeo.org/1.0.0\">" << std::endl
+        << "  <Title>" << title << "</Title>" << std::endl
+        << "  <Abstract>eqEarth benchmark tiles</Abstract>" << std::endl
+        << "  <SRS>EPSG:4326</SRS>" << std::endl
+        << "  <BoundingBox minx=\"-180\" miny=\"-90\" maxx=\"180\""
+        << " maxy=\"90\"/>" << std::endl
+        << "  <Origin x=\"-180\" y=\"-90\"/>" << std::endl
+        << "  <TileFormat width=\"" << size << "\" height=\"" << size
+        << "\" mime-type=\"" << mimeType << "\" extension=\"" << extension
+        << "\"/>" << std::endl
+        << "  <TileSets profile=\"global-geodetic\">" << std::endl;
+
+    for( uint32_t level = 0; level <= BENCH_MAX_LEVEL; ++level )
+        file << "    <TileSet href=\"" << level << "\" units-per-pixel=\""
+            << tileSize( level ) / size << "\" order=\"" << level << "\"/>"
+            << std::endl;
+
+    file << "  </TileSets>" << std::endl
+        << "</TileMap>" << std::endl;
+    return file.good( );
+}
+
+int main( const int argc, char** argv )
+{
+    if( argc != 3 )
+    {
+        std::cerr << "Usage: " << argv[0] << " <dir> <viewpoints>"
+            << std::endl;
+        return EXIT_FAILURE;
+    }
+    const std::string dir = argv[1];
+
+    std::vector< uint32_t > viewpoints;
+    if( !parseViewpoints( argv[2], viewpoints ))
+        return EXIT_FAILURE;
+
+    std::set< Tile > tiles;
+    for( uint32_t level = 0; level <= BENCH_MAX_LEVEL; ++level )
+    {
+        const uint32_t numX = 2 << level, numY = 1 << level;
+        const double size = tileSize( level );
+
+        if( level <= BENCH_GLOBAL_LEVEL )
+        {
+            for( uint32_t y = 0; y < numY; ++y )
+                for( uint32_t x = 0; x < numX; ++x )
+                {
+                    const Tile tile = { level, x, y };
+                    tiles.insert( tile );
+                }
+            continue;
+        }
+
+        for( size_t i = 0; i < viewpoints.size( ); ++i )
+        {
+            const osgEarth::Viewpoint& vp = VPs[ viewpoints[i]];
+            const int x = static_cast< int >(( vp.x( ) + 180. ) / size );
+            const int y = static_cast< int >(( vp.y( ) + 90. ) / size );
+
+            for( int dy = -BENCH_TILES_AROUND; dy <= BENCH_TILES_AROUND; ++dy )
+                for( int dx = -BENCH_TILES_AROUND; dx <= BENCH_TILES_AROUND;
+                     ++dx )
+                {
+                    if( y + dy < 0 || y + dy >= int( numY ))
+                        continue;
+
+                    // wrap around the antimeridian
+                    const Tile tile = { level, ( x + dx + numX ) % numX,
+                                        uint32_t( y + dy ) };
+                    tiles.insert( tile );
+                }
+        }
+    }
+
+    std::cout << "Writing " << tiles.size( ) << " tiles to " << dir
+        << std::endl;
+    for( std::set< Tile >::const_iterator i = tiles.begin( );
+         i != tiles.end( ); ++i )
+    {
+        writeImage( dir, *i );
+        writeElevation( dir, *i );
+    }
+
+    // last, so that an interrupted run is redone by make
+    if( !writeTileMap( dir + "/elevation/tms.xml", "Elevation",
+            ELEVATION_SIZE, "image/tiff", "tif" ) ||
+        !writeTileMap( dir + "/imagery/tms.xml", "Imagery", IMAGE_SIZE,
+            "image/jpeg", "jpg" ))
+    {
+        std::cerr << "Cannot write the tile maps to " << dir << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,209 @@
+#include "benchmark.h"
+
+#include "config.h"
+#include "earthManipulator.h"
+#include "view.h"
+#include "vps.h"
+
+#include <osgDB/Registry>
+#include <osgEarthUtil/EarthManipulator>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sys/resource.h>
+
+#define EARTH_RADIUS 6371e3
+
+namespace eqEarth
+{
+// ----------------------------------------------------------------------------
+
+// Counts the nodes read by the pager, i.e. tiles once the map is loaded
+struct TileCounter : public osgDB::Registry::ReadFileCallback
+{
+TileCounter( osgDB::Registry::ReadFileCallback* callback )
+    : previous( callback )
+    , numTiles( 0 )
+{
+}
+
+virtual osgDB::ReaderWriter::ReadResult readNode( const std::string& fileName,
+        const osgDB::Options* options )
+{
+    ++numTiles;
+    return previous.valid( ) ? previous->readNode( fileName, options ) :
+        osgDB::Registry::ReadFileCallback::readNode( fileName, options );
+}
+
+osg::ref_ptr< osgDB::Registry::ReadFileCallback > previous;
+lunchbox::a_int32_t numTiles;
+};
+
+// ----------------------------------------------------------------------------
+
+struct ViewpointSetter : public eq::ConfigVisitor
+{
+ViewpointSetter( const osgEarth::Viewpoint& vp )
+    : _vp( vp )
+{
+}
+
+virtual eq::VisitorResult visit( eq::View* view )
+{
+    osgViewer::View* osgView = static_cast< View* >( view )->getOSGView( );
+    osgGA::CameraManipulator* m = osgView ?
+        osgView->getCameraManipulator( ) : 0;
+
+    // setViewpoint is not virtual in osgEarth, ours tracks the generation
+    EarthManipulator* eem = dynamic_cast< EarthManipulator* >( m );
+    osgEarth::Util::EarthManipulator* em =
+        dynamic_cast< osgEarth::Util::EarthManipulator* >( m );
+    if( eem )
+        eem->setViewpoint( _vp, 0. );
+    else if( em )
+        em->setViewpoint( _vp, 0. );
+
+    return eq::TRAVERSE_CONTINUE;
+}
+
+const osgEarth::Viewpoint& _vp;
+};
+
+// ----------------------------------------------------------------------------
+
+static osgEarth::Viewpoint interpolate( const osgEarth::Viewpoint& a,
+        const osgEarth::Viewpoint& b, const double t )
+{
+    double dLon = b.x( ) - a.x( );
+    if( dLon > 180. )
+        dLon -= 360.;
+    else if( dLon < -180. )
+        dLon += 360.;
+    const double dLat = b.y( ) - a.y( );
+
+    double lon = a.x( ) + dLon * t;
+    if( lon > 180. )
+        lon -= 360.;
+    else if( lon < -180. )
+        lon += 360.;
+    const double lat = a.y( ) + dLat * t;
+
+    // Climb half way so that the distance flown is in view
+    const double distance = EARTH_RADIUS *
+        osg::DegreesToRadians( sqrt( dLon * dLon + dLat * dLat ));
+    const double range =
+        exp( log( a.getRange( )) * ( 1. - t ) + log( b.getRange( )) * t ) +
+        sin( osg::PI * t ) * distance;
+
+    return osgEarth::Viewpoint( osg::Vec3d( lon, lat, 0. ),
+        a.getHeading( ) + ( b.getHeading( ) - a.getHeading( )) * t,
+        a.getPitch( ) + ( b.getPitch( ) - a.getPitch( )) * t,
+        range, a.getSRS( ));
+}
+
+static float percentile( const std::vector< float >& sorted, const float p )
+{
+    if( sorted.empty( ))
+        return 0.f;
+
+    const size_t n = std::min( sorted.size( ) - 1,
+        static_cast< size_t >( p / 100.f * sorted.size( )));
+    return sorted[ n ];
+}
+
+// ----------------------------------------------------------------------------
+
+Benchmark::Benchmark( const std::string& viewpoints,
+        const uint32_t framesPerLeg )
+    : _framesPerLeg( std::max( framesPerLeg, 1U ))
+    , _frame( 0U )
+{
+    parseViewpoints( viewpoints, _viewpoints );
+
+    _tileCounter = new TileCounter(
+        osgDB::Registry::instance( )->getReadFileCallback( ));
+    osgDB::Registry::instance( )->setReadFileCallback( _tileCounter );
+}
+
+Benchmark::~Benchmark( )
+{
+    osgDB::Registry::instance( )->setReadFileCallback(
+        _tileCounter->previous );
+}
+
+bool Benchmark::frame( Config* config )
+{
+    if( _frame > 0 )
+        _frameTimes.push_back( _clock.resetTimef( ));
+    else
+        _clock.reset( );
+
+    const uint32_t numLegs = _viewpoints.size( ) - 1;
+    if( _frame >= numLegs * _framesPerLeg )
+    {
+        report( );
+        return false;
+    }
+
+    const uint32_t leg = _frame / _framesPerLeg;
+    const double t =
+        static_cast< double >( _frame % _framesPerLeg ) / _framesPerLeg;
+
+    const osgEarth::Viewpoint vp = interpolate( VPs[ _viewpoints[ leg ]],
+        VPs[ _viewpoints[ leg + 1 ]], t );
+
+    ViewpointSetter m( vp );
+    config->accept( m );
+
+    _startTimes[ config->getCurrentFrame( ) + 1 ] = _runClock.getTimef( );
+    ++_frame;
+    return true;
+}
+
+void Benchmark::frameFinished( const uint32_t frameNumber )
+{
+    std::map< uint32_t, float >::iterator i = _startTimes.find( frameNumber );
+    if( i == _startTimes.end( ))
+        return;
+
+    _latencies.push_back( _runClock.getTimef( ) - i->second );
+    _startTimes.erase( i );
+}
+
+void Benchmark::report( ) const
+{
+    std::vector< float > times( _frameTimes );
+    std::sort( times.begin( ), times.end( ));
+
+    std::vector< float > latencies( _latencies );
+    std::sort( latencies.begin( ), latencies.end( ));
+    float latencySum = 0.f;
+    for( size_t i = 0; i < latencies.size( ); ++i )
+        latencySum += latencies[ i ];
+
+    float sum = 0.f;
+    for( size_t i = 0; i < times.size( ); ++i )
+        sum += times[ i ];
+
+    struct rusage usage;
+    getrusage( RUSAGE_SELF, &usage );
+
+    std::cout << std::fixed << std::setprecision( 2 )
+        << "bench frames " << times.size( ) << std::endl
+        << "bench frame ms mean "
+        << ( times.empty( ) ? 0.f : sum / times.size( ))
+        << " p50 " << percentile( times, 50.f )
+        << " p95 " << percentile( times, 95.f )
+        << " p99 " << percentile( times, 99.f )
+        << " max " << ( times.empty( ) ? 0.f : times.back( )) << std::endl
+        << "bench latency ms mean "
+        << ( latencies.empty( ) ? 0.f : latencySum / latencies.size( ))
+        << " p50 " << percentile( latencies, 50.f )
+        << " p95 " << percentile( latencies, 95.f )
+        << " p99 " << percentile( latencies, 99.f ) << std::endl
+        << "bench tiles paged " << int32_t( _tileCounter->numTiles )
+        << std::endl
+        << "bench peak RSS " << usage.ru_maxrss / 1024 << " MB" << std::endl;
+}
+}
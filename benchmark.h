@@ -0,0 +1,51 @@
+#pragma once
+
+#include <eq/eq.h>
+
+#include <osg/ref_ptr>
+
+#include <map>
+
+namespace eqEarth
+{
+class Config;
+struct TileCounter;
+
+/**
+ * Flies all views through a list of vps.h viewpoints, one leg per pair, a
+ * fixed number of frames per leg. The path only depends on the frame
+ * count, so runs on the same hardware can be compared. Reports frame time
+ * and latency percentiles, tiles paged and peak RSS when done.
+ */
+class Benchmark
+{
+public:
+    /** @param viewpoints indices into VPs, e.g. "0-9,12". */
+    Benchmark( const std::string& viewpoints, const uint32_t framesPerLeg );
+    ~Benchmark( );
+
+    bool isValid( ) const { return _viewpoints.size( ) > 1; }
+
+    /** Move the views for the next frame. @return false when done. */
+    bool frame( Config* config );
+
+    /** The given frame was finished, for the latency since its start. */
+    void frameFinished( const uint32_t frameNumber );
+
+private:
+    std::vector< uint32_t > _viewpoints;
+    const uint32_t _framesPerLeg;
+    uint32_t _frame;
+
+    lunchbox::Clock _clock;
+    std::vector< float > _frameTimes;
+
+    lunchbox::Clock _runClock;
+    std::map< uint32_t, float > _startTimes; // by frame number
+    std::vector< float > _latencies;
+
+    osg::ref_ptr< TileCounter > _tileCounter;
+
+    void report( ) const;
+};
+}
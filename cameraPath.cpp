@@ -0,0 +1,109 @@
+#include "cameraPath.h"
+
+#include "view.h"
+
+#define CAMERA_PATH_MAGIC   0x45504345 // "ECPE"
+#define CAMERA_PATH_VERSION 1
+
+namespace eqEarth
+{
+// ----------------------------------------------------------------------------
+
+CameraPath::CameraPath( const std::string& fileName, const Mode mode )
+    : _mode( mode )
+    , _numFrames( 0U )
+{
+    const std::ios_base::openmode flags = std::ios_base::binary |
+        (( mode == MODE_RECORD ) ? std::ios_base::out : std::ios_base::in );
+    _file.open( fileName.c_str( ), flags );
+
+    uint32_t magic = CAMERA_PATH_MAGIC;
+    uint32_t version = CAMERA_PATH_VERSION;
+    if( mode == MODE_RECORD )
+    {
+        _write( magic );
+        _write( version );
+    }
+    else
+    {
+        _read( magic );
+        _read( version );
+        if( magic != CAMERA_PATH_MAGIC || version != CAMERA_PATH_VERSION )
+            _file.setstate( std::ios_base::failbit );
+    }
+
+    if( !_file )
+        LBWARN << "Unable to " << (( mode == MODE_RECORD ) ? "record" :
+            "replay" ) << " camera path " << fileName << std::endl;
+}
+
+CameraPath::~CameraPath( )
+{
+    LBINFO << ( isReplaying( ) ? "Replayed " : "Recorded " ) << _numFrames
+        << " frames" << std::endl;
+}
+
+bool CameraPath::frame( double& simulationTime,
+        const std::vector< View* >& views )
+{
+    uint32_t numViews = views.size( );
+    double near, far, lat, lon;
+
+    if( _mode == MODE_RECORD )
+    {
+        _write( simulationTime );
+        _write( numViews );
+
+        for( size_t i = 0; i < views.size( ); ++i )
+        {
+            const View* view = views[ i ];
+            view->getNearFar( near, far );
+            view->getLatLon( lat, lon );
+
+            _write( view->getViewMatrix( ));
+            _write( near );
+            _write( far );
+            _write( lat );
+            _write( lon );
+        }
+    }
+    else
+    {
+        _read( simulationTime );
+        _read( numViews );
+        if( !_file )
+            return false;
+
+        if( numViews != views.size( ))
+        {
+            LBWARN << "Camera path has " << numViews << " views, config "
+                << views.size( ) << std::endl;
+            return false;
+        }
+
+        for( size_t i = 0; i < views.size( ); ++i )
+        {
+            View* view = views[ i ];
+            eq::Matrix4f viewMatrix;
+
+            _read( viewMatrix );
+            _read( near );
+            _read( far );
+            _read( lat );
+            _read( lon );
+            if( !_file )
+                return false;
+
+            view->setViewMatrix( viewMatrix );
+            view->setNearFar( near, far );
+            view->setLatLon( lat, lon );
+        }
+    }
+
+    if( !_file )
+        return false;
+
+    ++_numFrames;
+    return true;
+}
+}
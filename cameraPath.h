@@ -0,0 +1,48 @@
+#pragma once
+
+#include <eq/eq.h>
+
+#include <fstream>
+
+namespace eqEarth
+{
+class View;
+
+/**
+ * Records the simulation time and the camera of every view per frame to a
+ * binary file, or replays such a file in place of the manipulators. Views
+ * are matched by config traversal order, so replay with the same config.
+ */
+class CameraPath
+{
+public:
+    enum Mode
+    {
+        MODE_RECORD,
+        MODE_REPLAY
+    };
+
+    CameraPath( const std::string& fileName, const Mode mode );
+    ~CameraPath( );
+
+    bool isValid( ) const { return _file.good( ); }
+    bool isReplaying( ) const { return _mode == MODE_REPLAY; }
+
+    /**
+     * Write the next frame, or read it into time and views.
+     * @return false at the end of a replay or on error.
+     */
+    bool frame( double& simulationTime, const std::vector< View* >& views );
+
+private:
+    const Mode _mode;
+    std::fstream _file;
+    uint32_t _numFrames;
+
+    template< typename T > void _write( const T& value )
+        { _file.write( reinterpret_cast< const char* >( &value ),
+            sizeof( T )); }
+    template< typename T > void _read( T& value )
+        { _file.read( reinterpret_cast< char* >( &value ), sizeof( T )); }
+};
+}
@@ -3,12 +3,29 @@
 #include "config.h"
 #include "configEvent.h"
 #include "node.h"
+#include "pipe.h"
+#include "trace.h"
 #include "window.h"
 #include "view.h"
 #include "viewer.h"
 #include "util.h"
 
+#include <osg/Drawable>
+
 #include <GL/glu.h>
+#include <unistd.h>
+
+#define LOD_SCALE_MAX 8.f
+
+#define RESOLUTION_MIN 0.5f
+#define RESOLUTION_STEP 0.05f // raised per frame while well within target
+#define RESOLUTION_HEADROOM 0.7f // of the target draw time
+
+// MB/s, from 10GbE on compressing takes longer than sending, below GbE a
+// lossy color compressor pays for its artifacts
+#define COMPRESSION_FAST_LINK 1000.f
+#define COMPRESSION_SLOW_LINK 100.f
+#define COMPRESSION_LOSSY_QUALITY 0.5f
 
 namespace eqEarth
 {
@@ -17,9 +34,26 @@ namespace eqEarth
 Channel::Channel( eq::Window* parent )
     : eq::Channel( parent )
     , _sceneID( eq::UUID::ZERO )
+    , _logDepthBuffer( 0 )
     , _overlayID( eq::UUID::ZERO )
+    , _motionPending( false )
+    , _motionX( 0 ), _motionY( 0 )
+    , _motionTime( 0. )
+    , _lodDensity( 0.f )
+    , _lodFactor( 1.f )
+    , _targetDrawTime( 0.f )
+    , _resolution( 1.f )
+    , _upsampleTexture( 0 )
+    , _drawQuery( 0 )
+    , _numDrawQueries( 0 )
+    , _compression( InitData::COMPRESSION_AUTO )
+    , _dropAlpha( false )
+    , _compositeThreads( 0 )
+    , _compositor( 0 )
 {
 LBINFO << "=====> Channel::Channel(" << (void *)this << ")" << std::endl;
+
+    _drawQueries[0] = _drawQueries[1] = 0;
 }
 
 Channel::~Channel( )
@@ -29,7 +63,7 @@ LBINFO << "<===== Channel::~Channel(" << (void *)this << ")" << std::endl;
 
 const FrameData& Channel::getFrameData( ) const
 {
-    return static_cast< const Node* >( getNode( ))->getFrameData( );
+    return static_cast< const Pipe* >( getPipe( ))->getFrameData( );
 }
 
 bool Channel::configInit( const eq::uint128_t& initID )
@@ -50,17 +84,6 @@ LBINFO << "-----> Channel::configInit(" << initID <<
         osg::ref_ptr< osg::GraphicsContext > gc =
             static_cast< const Window* >( getWindow( ))->getGraphicsContext( );
 
-        _camera = new osg::Camera;
-        _camera->setColorMask( new osg::ColorMask );
-        _camera->setViewport( new osg::Viewport );
-        _camera->setGraphicsContext( gc );
-#if 1
-        _camera->setComputeNearFarMode(
-            osg::CullSettings::DO_NOT_COMPUTE_NEAR_FAR );
-#endif
-        _camera->setReferenceFrame( osg::Transform::ABSOLUTE_RF );
-        _camera->setAllowEventFocus( false );
-
         if( isDestination( ) &&
                 ( std::string::npos == getNode( )->getName( ).find( "strad" )))
         {
@@ -110,6 +133,42 @@ LBINFO << "-----> Channel::configInit(" << initID <<
         }
     }
 
+    _stats.setName( "channel " + getName( ));
+
+    {
+        const InitData& initData =
+            static_cast< const Config* >( getConfig( ))->getInitData( );
+        _lodDensity = initData.getLODDensity( );
+        if( initData.getTargetFPS( ) > 0.f )
+            _targetDrawTime = 1000.f / initData.getTargetFPS( );
+
+        _compositeThreads = initData.getCompositeThreads( );
+
+        _dropAlpha = initData.getDropAlpha( );
+        _compression = initData.getCompression( );
+        const float bandwidth = initData.getLinkBandwidth( );
+        if(( _compression == InitData::COMPRESSION_AUTO ) &&
+            ( bandwidth > 0.f ))
+        {
+            if( bandwidth >= COMPRESSION_FAST_LINK )
+                _compression = InitData::COMPRESSION_NONE;
+            else if( bandwidth >= COMPRESSION_SLOW_LINK )
+                _compression = InitData::COMPRESSION_LOSSLESS;
+            else
+                _compression = InitData::COMPRESSION_LOSSY;
+        }
+    }
+    {
+        const size_t lod = getName( ).find( "lod=" );
+        if( lod != std::string::npos )
+            _lodFactor = atof( getName( ).c_str( ) + lod + 4 );
+        if( _lodFactor <= 0.f )
+        {
+            LBWARN << "Invalid LOD factor in " << getName( ) << std::endl;
+            _lodFactor = 1.f;
+        }
+    }
+
     init = true;
 
 out:
@@ -140,6 +199,7 @@ void Channel::frameStart( const eq::uint128_t& frameID,
 //LBINFO << "<----- Channel<" << getName( ) << ">::frameStart("
 //    << frameID << ", " << frameNumber << ")" << std::endl;
 }
+#endif
 
 void Channel::frameFinish( const eq::uint128_t& frameID,
         const uint32_t frameNumber )
@@ -147,12 +207,15 @@ void Channel::frameFinish( const eq::uint128_t& frameID,
 //LBINFO << "-----> Channel<" << getName( ) << ">::frameFinish("
 //    << frameID << ", " << frameNumber << ")" << std::endl;
 
+    _stats.finish( frameNumber );
+
     eq::Channel::frameFinish( frameID, frameNumber );
 
 //LBINFO << "<----- Channel<" << getName( ) << ">::frameFinish("
 //    << frameID << ", " << frameNumber << ")" << std::endl;
 }
 
+#if 0
 void Channel::frameDrawFinish( const eq::uint128_t& frameID,
         const uint32_t frameNumber )
 {
@@ -168,8 +231,8 @@ void Channel::frameDrawFinish( const eq::uint128_t& frameID,
 
 void Channel::frameClear( const eq::uint128_t& frameID )
 {
-LBINFO << "-----> Channel<" << getName( ) << ">::frameClear("
-    << frameID << ")" << std::endl;
+    EQEARTH_TRACE_SCOPE( "Channel::frameClear",
+        getPipe( )->getCurrentFrame( ));
 
 /*
     if( isDestination( ))
@@ -184,55 +247,107 @@ LBINFO << "-----> Channel<" << getName( ) << ">::frameClear("
     glEnable( GL_SCISSOR_TEST );
 
     eq::Channel::frameClear( frameID );
-
-LBINFO << "<----- Channel<" << getName( ) << ">::frameClear("
-    << frameID << ")" << std::endl;
 }
 
 void Channel::frameDraw( const eq::uint128_t& frameID )
 {
-LBINFO << "-----> Channel<" << getName( ) << ">::frameDraw("
-    << frameID << ")" << std::endl;
+    EQEARTH_TRACE_SCOPE( "Channel::frameDraw",
+        getPipe( )->getCurrentFrame( ));
 
-    const View* view = static_cast< const View* >( getView( ));
+    View* view = static_cast< View* >( getView( ));
     LBASSERT( view );
 
+    // The camera comes with the frame data of this pipe
+    view->setFrameData( &getFrameData( ));
+
     connectCameraToScene( view->getSceneID( ));
 
 #if 1
-    // Update near/far
+    // Update near/far, the same for all sources of a DB compound so that
+    // their depth buffers composite
     double near, far;
     view->getNearFar( near, far );
-/*
-    double r = far - near;
-
-    const eq::Range &range = getRange( );
-    near += r * range.start;
-    far = near + ( r * range.end );
-*/
     setNearFar( near, far );
 #endif
 
-    __applyBuffer( _camera );
-    __applyViewport( _camera );
+    if( _renderer.valid( ))
+    {
+        const Node* node = static_cast< const Node* >( getNode( ));
+        Pipe* pipe = static_cast< Pipe* >( getPipe( ));
+        CullThread* cullThread = pipe->getCullThread( );
 
-    __applyFrustum( _camera );
+        // Stereo passes would draw the other eye's cull result
+        const bool pipelined = cullThread && ( getEye( ) == eq::EYE_CYCLOP );
 
-    __applyHeadTransform( _camera );
+        // The camera is read by culls still in flight
+        if( cullThread )
+            cullThread->waitIdle( );
 
-    if( _renderer.valid( ))
-        static_cast< const Node* >( getNode( ))->renderLocked( _renderer );
+        // A pipelined draw would need the scale of the previous cull, and
+        // output frames would be read back with a partial depth buffer
+        const bool scaled = ( _targetDrawTime > 0.f ) && !pipelined &&
+            getOutputFrames( ).empty( );
 
-    updateView( );
+        __applyBuffer( _camera );
+        __applyViewport( _camera, scaled ? _resolution : 1.f );
+
+        __applyFrustum( _camera );
+        __applyLODScale( _camera );
+
+        __applyHeadTransform( _camera );
+
+        if( scaled )
+            beginDrawQuery( );
+
+        // DB compounds: this source's share of the view, composited by
+        // depth in frameAssemble
+        const eq::Range& range = getRange( );
+        _renderer->setRange( range.start, range.end );
+
+        if( pipelined )
+        {
+            // Cull this frame on the cull thread while drawing the cull
+            // result of the previous frame. The very first frame is culled
+            // twice so that there is always one result ahead.
+            if( _renderer->getNumCulled( ) == 0 )
+                node->cullLocked( _renderer );
+
+            // the cull drawn below, before the cull thread overwrites it
+            _stats.add( FrameStats::STAGE_CULL, _renderer->getCullTime( ));
+            addCullStats( );
+
+            cullThread->cull( _renderer );
+            node->drawLocked( _renderer );
+        }
+        else
+        {
+            _renderer->discardCulled( );
+            node->renderLocked( _renderer );
+
+            _stats.add( FrameStats::STAGE_CULL, _renderer->getCullTime( ));
+            addCullStats( );
+        }
+        _stats.add( FrameStats::STAGE_DRAW, _renderer->getDrawTime( ));
+
+        if( scaled )
+        {
+            // The draw call returns long before the GPU is done, its CPU
+            // time says little about the pixels drawn
+            const float drawTime = endDrawQuery( );
+            if( _resolution < 1.f )
+                upsample( );
+            if( drawTime >= 0.f )
+                updateResolution( drawTime );
+        }
+    }
 
-LBINFO << "<----- Channel<" << getName( ) << ">::frameDraw("
-    << frameID << ")" << std::endl;
+    updateView( );
 }
 
 void Channel::frameViewStart( const eq::uint128_t& frameID )
 {
-LBINFO << "-----> Channel<" << getName( ) << ">::frameViewStart("
-    << frameID << ")" << std::endl;
+    EQEARTH_TRACE_SCOPE( "Channel::frameViewStart",
+        getPipe( )->getCurrentFrame( ));
 
     eq::Channel::frameViewStart( frameID );
 
@@ -241,8 +356,7 @@ LBINFO << "-----> Channel<" << getName( ) << ">::frameViewStart("
         const View* view = static_cast< const View* >( getNativeView( ));
         LBASSERT( view );
 
-        const FrameData& frameData =
-            static_cast< const Node* >( getNode( ))->getFrameData( );
+        const FrameData& frameData = getFrameData( );
 
         connectCameraToOverlay( view->getOverlayID( ));
 
@@ -259,18 +373,16 @@ LBINFO << "-----> Channel<" << getName( ) << ">::frameViewStart("
         if( NULL != gmtime_r( &calendar, &now ))
             _viewer2d->getViewerFrameStamp( )->setCalendarTime( now );
 
+        queuePendingMotion( );
         _viewer2d->eventTraversal( );
         _viewer2d->updateTraversal( );
     }
-
-LBINFO << "<----- Channel<" << getName( ) << ">::frameViewStart("
-    << frameID << ")" << std::endl;
 }
 
 void Channel::frameViewFinish( const eq::uint128_t& frameID )
 {
-LBINFO << "-----> Channel<" << getName( ) << ">::frameViewFinish("
-    << frameID << ")" << std::endl;
+    EQEARTH_TRACE_SCOPE( "Channel::frameViewFinish",
+        getPipe( )->getCurrentFrame( ));
 
     if( _viewer2d.valid( ))
     {
@@ -285,15 +397,11 @@ LBINFO << "-----> Channel<" << getName( ) << ">::frameViewFinish("
     applyBuffer( );
     applyViewport( );
 
-    const FrameData& frameData =
-        static_cast< const Node* >( getNode( ))->getFrameData( );
+    const FrameData& frameData = getFrameData( );
     if( frameData.useStatistics( ))
         drawStatistics( );
 
     eq::Channel::frameViewFinish( frameID );
-
-LBINFO << "<----- Channel<" << getName( ) << ">::frameViewFinish("
-    << frameID << ")" << std::endl;
 }
 
 void Channel::frameAssemble( const eq::uint128_t& frameID )
@@ -301,7 +409,10 @@ void Channel::frameAssemble( const eq::uint128_t& frameID )
 //LBINFO << "-----> Channel<" << getName( ) << ">::frameAssemble("
 //    << frameID << ")" << std::endl;
 
-    eq::Channel::frameAssemble( frameID );
+    const lunchbox::Clock clock;
+    if( !compositeFrames( ))
+        eq::Channel::frameAssemble( frameID );
+    _stats.add( FrameStats::STAGE_ASSEMBLE, clock.getTimef( ));
 
 //LBINFO << "<----- Channel<" << getName( ) << ">::frameAssemble("
 //    << frameID << ")" << std::endl;
@@ -312,22 +423,42 @@ void Channel::frameReadback( const eq::uint128_t& frameID )
 //LBINFO << "-----> Channel<" << getName( ) << ">::frameReadback("
 //    << frameID << ")" << std::endl;
 
-#if 0
-    const eq::Frames& frames = getOutputFrames();
-    for( eq::FramesCIter i = frames.begin(); i != frames.end(); ++i )
+    const eq::Frames& frames = getOutputFrames( );
+    for( eq::FramesCIter i = frames.begin( ); i != frames.end( ); ++i )
     {
         eq::Frame* frame = *i;
-        // OPT: Drop alpha channel from all frames during network transport
-        frame->setAlphaUsage( false );
+        if( _dropAlpha )
+            frame->setAlphaUsage( false );
 
-        if( false )
-            frame->useCompressor( eq::Frame::BUFFER_COLOR, EQ_COMPRESSOR_AUTO );
-        else
+        switch( _compression )
+        {
+        case InitData::COMPRESSION_NONE:
             frame->useCompressor( eq::Frame::BUFFER_COLOR, EQ_COMPRESSOR_NONE );
+            frame->useCompressor( eq::Frame::BUFFER_DEPTH, EQ_COMPRESSOR_NONE );
+            break;
+
+        case InitData::COMPRESSION_LOSSLESS:
+        case InitData::COMPRESSION_LOSSY:
+            frame->useCompressor( eq::Frame::BUFFER_COLOR, EQ_COMPRESSOR_AUTO );
+            frame->useCompressor( eq::Frame::BUFFER_DEPTH, EQ_COMPRESSOR_AUTO );
+            frame->setQuality( eq::Frame::BUFFER_COLOR,
+                ( _compression == InitData::COMPRESSION_LOSSY ) ?
+                    COMPRESSION_LOSSY_QUALITY : 1.f );
+            // a lossy depth buffer breaks compositing
+            frame->setQuality( eq::Frame::BUFFER_DEPTH, 1.f );
+            break;
+
+        default: // Equalizer's choice
+            break;
+        }
     }
-#endif
 
+    const lunchbox::Clock clock;
     eq::Channel::frameReadback( frameID );
+    _stats.add( FrameStats::STAGE_READBACK, clock.getTimef( ));
+
+    if( FrameStats::isEnabled( ))
+        addTransportStats( );
 
 //LBINFO << "<----- Channel<" << getName( ) << ">::frameReadback("
 //    << frameID << ")" << std::endl;
@@ -352,6 +483,17 @@ bool Channel::processEvent( const eq::Event& event )
         const uint32_t y =
             pvp.h - event.pointer.y + pvp.y + ( vp.y * ( pvp.h / vp.h ));
 
+        // Keep the order of motions to the other events
+        if( event.type == eq::Event::CHANNEL_POINTER_MOTION )
+        {
+            _motionPending = true;
+            _motionX = x;
+            _motionY = y;
+            _motionTime = time;
+            return eq::Channel::processEvent( event );
+        }
+        queuePendingMotion( );
+
         switch( event.type )
         {
             case eq::Event::WINDOW_POINTER_WHEEL:
@@ -369,9 +511,6 @@ bool Channel::processEvent( const eq::Event& event )
                 eventQueue->mouseScroll( sm, time );
                 break;
             }
-            case eq::Event::CHANNEL_POINTER_MOTION:
-                eventQueue->mouseMotion( x, y, time );
-                break;
             case eq::Event::CHANNEL_POINTER_BUTTON_PRESS:
             {
                 const unsigned int b = eqButtonToOsg( event.pointer.button );
@@ -405,6 +544,306 @@ bool Channel::processEvent( const eq::Event& event )
     return eq::Channel::processEvent( event );
 }
 
+// Stretch the scaled draw in the lower left corner over the whole channel
+void Channel::upsample( )
+{
+    const eq::PixelViewport& pvp = getPixelViewport( );
+    const int32_t w = std::max( 1, int32_t( pvp.w * _resolution ));
+    const int32_t h = std::max( 1, int32_t( pvp.h * _resolution ));
+
+    glPushAttrib( GL_ALL_ATTRIB_BITS );
+
+    if( !_upsampleTexture )
+        glGenTextures( 1, &_upsampleTexture );
+    glBindTexture( GL_TEXTURE_2D, _upsampleTexture );
+
+    if(( _upsampleSize.w != pvp.w ) || ( _upsampleSize.h != pvp.h ))
+    {
+        glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA8, pvp.w, pvp.h, 0, GL_RGBA,
+            GL_UNSIGNED_BYTE, 0 );
+        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+        glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+        _upsampleSize = pvp;
+    }
+    glCopyTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, pvp.x, pvp.y, w, h );
+
+    glViewport( pvp.x, pvp.y, pvp.w, pvp.h );
+    glScissor( pvp.x, pvp.y, pvp.w, pvp.h );
+    glDisable( GL_DEPTH_TEST );
+    glDisable( GL_LIGHTING );
+    glDisable( GL_BLEND );
+    glDisable( GL_CULL_FACE );
+    glEnable( GL_TEXTURE_2D );
+    glTexEnvi( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE );
+
+    glMatrixMode( GL_PROJECTION );
+    glPushMatrix( );
+    glLoadIdentity( );
+    glMatrixMode( GL_MODELVIEW );
+    glPushMatrix( );
+    glLoadIdentity( );
+
+    const float u = float( w ) / pvp.w;
+    const float v = float( h ) / pvp.h;
+    glBegin( GL_QUADS );
+    glTexCoord2f( 0.f, 0.f ); glVertex2f( -1.f, -1.f );
+    glTexCoord2f( u, 0.f );   glVertex2f( 1.f, -1.f );
+    glTexCoord2f( u, v );     glVertex2f( 1.f, 1.f );
+    glTexCoord2f( 0.f, v );   glVertex2f( -1.f, 1.f );
+    glEnd( );
+
+    glMatrixMode( GL_PROJECTION );
+    glPopMatrix( );
+    glMatrixMode( GL_MODELVIEW );
+    glPopMatrix( );
+
+    glPopAttrib( );
+}
+
+// Timer queries come with OSG's extensions, Equalizer's GLEW is not used
+static osg::Drawable::Extensions* _getDrawableExtensions(
+    const eq::Window* window )
+{
+    const unsigned int contextID =
+        static_cast< const Window* >( window )->getContextID( );
+    return osg::Drawable::getExtensions( contextID, true );
+}
+
+void Channel::beginDrawQuery( )
+{
+    osg::Drawable::Extensions* ext = _getDrawableExtensions( getWindow( ));
+    if( !ext->isTimerQuerySupported( ))
+        return;
+
+    if( !_drawQueries[0] )
+        ext->glGenQueries( 2, _drawQueries );
+    ext->glBeginQuery( GL_TIME_ELAPSED, _drawQueries[ _drawQuery ] );
+}
+
+// @return the GPU time in ms of the last draw, read a frame late so that it
+// does not stall the pipeline, or the frame time without timer queries; -1
+// if there is nothing to go by yet
+float Channel::endDrawQuery( )
+{
+    osg::Drawable::Extensions* ext = _getDrawableExtensions( getWindow( ));
+    if( !ext->isTimerQuerySupported( ))
+    {
+        const float frameTime = _frameClock.resetTimef( );
+        return ( _numDrawQueries++ > 0 ) ? frameTime : -1.f;
+    }
+
+    ext->glEndQuery( GL_TIME_ELAPSED );
+    _drawQuery = 1 - _drawQuery;
+    if( _numDrawQueries < 2 )
+        ++_numDrawQueries;
+    if( _numDrawQueries < 2 )
+        return -1.f;
+
+    // issued a frame ago, usually done by now, else try the next frame
+    GLint available = 0;
+    ext->glGetQueryObjectiv( _drawQueries[ _drawQuery ],
+        GL_QUERY_RESULT_AVAILABLE, &available );
+    if( !available )
+        return -1.f;
+
+    GLuint64EXT elapsed = 0;
+    ext->glGetQueryObjectui64v( _drawQueries[ _drawQuery ], GL_QUERY_RESULT,
+        &elapsed );
+    return elapsed / 1000000.f;
+}
+
+// Compresses a copy of the output images as Equalizer's transmitter does and
+// decompresses it again as the destination will, so that the sizes and times
+// of both ends show in these stats. The output images themselves belong to
+// the transmit thread once read back, they are only read here.
+void Channel::addTransportStats( )
+{
+    const eq::Frames& frames = getOutputFrames( );
+    for( eq::FramesCIter i = frames.begin( ); i != frames.end( ); ++i )
+    {
+        const eq::Images& images = ( *i )->getImages( );
+        for( eq::ImagesCIter j = images.begin( ); j != images.end( ); ++j )
+        {
+            const eq::Image* image = *j;
+            for( uint32_t k = 0; k < 2; ++k )
+            {
+                const eq::Frame::Buffer buffer = ( k == 0 ) ?
+                    eq::Frame::BUFFER_COLOR : eq::Frame::BUFFER_DEPTH;
+                if( !image->hasPixelData( buffer ))
+                    continue;
+
+                const uint32_t rawSize =
+                    uint32_t( image->getPixelDataSize( buffer ));
+                _stats.count( FrameStats::COUNTER_RAW_BYTES, rawSize );
+                if( _compression == InitData::COMPRESSION_NONE )
+                {
+                    _stats.count( FrameStats::COUNTER_COMPRESSED_BYTES,
+                        rawSize );
+                    continue;
+                }
+
+                _transportImage.setAlphaUsage( image->getAlphaUsage( ));
+                _transportImage.setQuality( buffer,
+                    image->getQuality( buffer ));
+                _transportImage.setPixelData( buffer,
+                    image->getPixelData( buffer ));
+
+                lunchbox::Clock clock;
+                const eq::PixelData& data =
+                    _transportImage.compressPixelData( buffer );
+                _stats.add( FrameStats::STAGE_COMPRESS, clock.resetTimef( ));
+                if( !data.isCompressed )
+                {
+                    _stats.count( FrameStats::COUNTER_COMPRESSED_BYTES,
+                        rawSize );
+                    continue;
+                }
+
+                uint64_t size = 0;
+                for( size_t l = 0; l < data.compressedSize.size( ); ++l )
+                    size += data.compressedSize[ l ];
+                _stats.count( FrameStats::COUNTER_COMPRESSED_BYTES,
+                    uint32_t( size ));
+
+                clock.reset( );
+                _receivedImage.setPixelData( buffer, data );
+                _stats.add( FrameStats::STAGE_DECOMPRESS, clock.getTimef( ));
+            }
+        }
+    }
+}
+
+// Drop the resolution right after a late frame, win it back slowly
+void Channel::updateResolution( const float drawTime )
+{
+    if( drawTime > _targetDrawTime )
+        // the draw time goes with the number of pixels
+        _resolution = std::max( RESOLUTION_MIN,
+            _resolution * sqrt( _targetDrawTime / drawTime ));
+    else if( drawTime < _targetDrawTime * RESOLUTION_HEADROOM )
+        _resolution = std::min( 1.f, _resolution + RESOLUTION_STEP );
+}
+
+bool Channel::compositeFrames( )
+{
+    const eq::Frames& frames = getInputFrames( );
+    if( _compositeThreads == 0 || frames.empty( ))
+        return false;
+
+    // 32 bit color and depth of DB compounds only, everything else is left
+    // to Equalizer
+    uint32_t format = 0;
+    for( eq::FramesCIter i = frames.begin( ); i != frames.end( ); ++i )
+    {
+        eq::Frame* frame = *i;
+        frame->waitReady( );
+
+        if(( frame->getZoom( ) != eq::Zoom::NONE ) ||
+            ( frame->getPixel( ) != eq::Pixel::ALL ))
+            return false;
+
+        const eq::Images& images = frame->getImages( );
+        for( eq::ImagesCIter j = images.begin( ); j != images.end( ); ++j )
+        {
+            const eq::Image* image = *j;
+            if( !image->hasPixelData( eq::Frame::BUFFER_COLOR ) ||
+                !image->hasPixelData( eq::Frame::BUFFER_DEPTH ) ||
+                ( image->getPixelSize( eq::Frame::BUFFER_COLOR ) != 4 ) ||
+                ( image->getExternalFormat( eq::Frame::BUFFER_DEPTH ) !=
+                    EQ_COMPRESSOR_DATATYPE_DEPTH_UNSIGNED_INT ))
+                return false;
+
+            const uint32_t color =
+                image->getExternalFormat( eq::Frame::BUFFER_COLOR );
+            if(( color != EQ_COMPRESSOR_DATATYPE_RGBA &&
+                    color != EQ_COMPRESSOR_DATATYPE_BGRA ) ||
+                ( format != 0 && color != format ))
+                return false;
+            format = color;
+        }
+    }
+
+    if( !_compositor )
+    {
+        // more threads than this host has only contend for the cores
+        const uint32_t numCPUs =
+            uint32_t( std::max( sysconf( _SC_NPROCESSORS_ONLN ), 1L ));
+        _compositor =
+            new DepthCompositor( std::min( _compositeThreads, numCPUs ));
+    }
+
+    for( eq::FramesCIter i = frames.begin( ); i != frames.end( ); ++i )
+    {
+        const eq::Frame* frame = *i;
+        const eq::Vector2i& offset = frame->getOffset( );
+        const eq::Images& images = frame->getImages( );
+        for( eq::ImagesCIter j = images.begin( ); j != images.end( ); ++j )
+        {
+            const eq::Image* image = *j;
+            const eq::PixelViewport& pvp = image->getPixelViewport( );
+            _compositor->addImage( reinterpret_cast< const uint32_t* >(
+                    image->getPixelPointer( eq::Frame::BUFFER_COLOR )),
+                reinterpret_cast< const uint32_t* >(
+                    image->getPixelPointer( eq::Frame::BUFFER_DEPTH )),
+                pvp.x + offset.x( ), pvp.y + offset.y( ), pvp.w, pvp.h );
+        }
+    }
+
+    if( !_compositor->composite( ))
+        return true;
+
+    setupAssemblyState( );
+    glPushAttrib( GL_ALL_ATTRIB_BITS );
+    glRasterPos2i( _compositor->getX( ), _compositor->getY( ));
+
+    // The depth where nearer than this channel's own draw, marking those
+    // pixels in the stencil ...
+    glEnable( GL_DEPTH_TEST );
+    glDepthFunc( GL_LESS );
+    glDepthMask( GL_TRUE );
+    glEnable( GL_STENCIL_TEST );
+    glStencilFunc( GL_ALWAYS, 1, 1 );
+    glStencilOp( GL_ZERO, GL_ZERO, GL_REPLACE );
+    glColorMask( GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE );
+    glDrawPixels( _compositor->getWidth( ), _compositor->getHeight( ),
+        GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, _compositor->getDepth( ));
+
+    // ... and the color of the marked pixels
+    glDisable( GL_DEPTH_TEST );
+    glStencilFunc( GL_EQUAL, 1, 1 );
+    glStencilOp( GL_KEEP, GL_KEEP, GL_KEEP );
+    glColorMask( GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE );
+    glDrawPixels( _compositor->getWidth( ), _compositor->getHeight( ),
+        ( format == EQ_COMPRESSOR_DATATYPE_BGRA ) ? GL_BGRA : GL_RGBA,
+        GL_UNSIGNED_BYTE, _compositor->getColor( ));
+
+    glPopAttrib( );
+    resetAssemblyState( );
+    return true;
+}
+
+void Channel::addCullStats( )
+{
+    _stats.count( FrameStats::COUNTER_HORIZON_TILES,
+        _renderer->getNumHorizonCulledTiles( ));
+    _stats.count( FrameStats::COUNTER_HORIZON_NODES,
+        _renderer->getNumHorizonCulledNodes( ));
+    _stats.count( FrameStats::COUNTER_RANGE_NODES,
+        _renderer->getNumRangeCulled( ));
+}
+
+void Channel::queuePendingMotion( )
+{
+    if( _motionPending )
+    {
+        _viewer2d->getEventQueue( )->mouseMotion( _motionX, _motionY,
+            _motionTime );
+        _motionPending = false;
+    }
+}
+
 void Channel::updateView( )
 {
 #if 0
@@ -515,47 +954,137 @@ void Channel::worldPick( const eq::Vector3d& origin,
 
 void Channel::cleanup( )
 {
-    if( _camera.valid( ))
-        connectCameraToScene( eq::UUID::ZERO );
-    _camera = 0;
+    releaseCameras( );
+
+    delete _logDepthBuffer;
+    _logDepthBuffer = 0;
+
+    if( _upsampleTexture )
+        glDeleteTextures( 1, &_upsampleTexture );
+    _upsampleTexture = 0;
+
+    if( _drawQueries[0] )
+        _getDrawableExtensions( getWindow( ))->glDeleteQueries( 2,
+            _drawQueries );
+    _drawQueries[0] = _drawQueries[1] = 0;
+    _numDrawQueries = 0;
+
+    delete _compositor;
+    _compositor = 0;
 
     if( _camera2d.valid( ))
         connectCameraToOverlay( eq::UUID::ZERO );
     _viewer2d = 0;
 }
 
+osg::Camera* Channel::createCamera( )
+{
+    osg::ref_ptr< osg::GraphicsContext > gc =
+        static_cast< Window* >( getWindow( ))->getGraphicsContext( );
+
+    osg::Camera* camera = new osg::Camera;
+    camera->setColorMask( new osg::ColorMask );
+    camera->setViewport( new osg::Viewport );
+    camera->setGraphicsContext( gc );
+#if 1
+    camera->setComputeNearFarMode(
+        osg::CullSettings::DO_NOT_COMPUTE_NEAR_FAR );
+#endif
+    camera->setReferenceFrame( osg::Transform::ABSOLUTE_RF );
+    camera->setAllowEventFocus( false );
+
+    const InitData& initData =
+        static_cast< const Config* >( getConfig( ))->getInitData( );
+    if( initData.getDepthMode( ) == InitData::DEPTH_LOG )
+    {
+        if( !_logDepthBuffer )
+            _logDepthBuffer = new osgEarth::Util::LogarithmicDepthBuffer;
+
+        if( _logDepthBuffer->supported( ))
+            _logDepthBuffer->install( camera );
+        else
+            LBWARN << "No logarithmic depth buffer support" << std::endl;
+    }
+
+    return camera;
+}
+
+void Channel::releaseCameras( )
+{
+    Node* node = static_cast< Node* >( getNode( ));
+
+    for( CameraMap::iterator i = _cameras.begin( ); i != _cameras.end( ); ++i )
+    {
+        if( i->second == _camera )
+            releaseRenderer( );
+
+        node->removeCameraFromOSGView( i->first, i->second );
+
+        i->second->setRenderer( 0 );
+    }
+    _cameras.clear( );
+
+    _sceneID = eq::UUID::ZERO;
+    _camera = 0;
+    _renderer = 0;
+}
+
+void Channel::releaseRenderer( )
+{
+    if( !_renderer.valid( ))
+        return;
+
+    // Don't leave a pipelined cull result behind to be drawn when this
+    // camera gets selected again
+    Pipe* pipe = static_cast< Pipe* >( getPipe( ));
+    if( pipe->getCullThread( ))
+        pipe->getCullThread( )->waitIdle( );
+
+    _renderer->discardCulled( );
+    _renderer = 0;
+}
+
 void Channel::connectCameraToScene( const eq::uint128_t& id )
 {
     LB_TS_THREAD( _pipeThread );
 
-    // TODO : reusing the same camera between osgViews costs expensive
-    // remove/add operations, make cameras per eq::View and find the
-    // right one to use on every frameDraw.
+    // Cameras stay attached to their osgView until configExit, so switching
+    // back and forth between views/layouts only selects a different camera
+    // instead of paying for remove/add and a new Renderer every time.
 
     if( id != _sceneID )
     {
-        Node* node = static_cast< Node* >( getNode( ));
+        releaseRenderer( );
 
-        Window::initCapabilities( _camera->getGraphicsContext( ));
+        _sceneID = id;
+        _camera = 0;
 
         if( eq::UUID::ZERO != _sceneID )
         {
-            node->removeCameraFromOSGView( _sceneID, _camera );
+            CameraMap::const_iterator i = _cameras.find( _sceneID );
+            if( i != _cameras.end( ))
+                _camera = i->second;
+            else
+            {
+                Node* node = static_cast< Node* >( getNode( ));
 
-            _camera->setRenderer( 0 );
-            _renderer = 0;
-        }
+                _camera = createCamera( );
 
-        _sceneID = id;
+                Window::initCapabilities( _camera->getGraphicsContext( ));
 
-        if( eq::UUID::ZERO != _sceneID )
-        {
-            node->addCameraToOSGView( _sceneID, _camera );
+                node->addCameraToOSGView( _sceneID, _camera );
 
-            _renderer =
-                static_cast< osgViewer::Renderer* >( _camera->getRenderer( ));
+                osgViewer::Renderer* renderer =
+                    static_cast< osgViewer::Renderer* >(
+                        _camera->getRenderer( ));
+                LBASSERT( renderer );
+                renderer->setGraphicsThreadDoesCull( false );
+
+                _cameras[ _sceneID ] = _camera;
+            }
+
+            _renderer = static_cast< Renderer* >( _camera->getRenderer( ));
             LBASSERT( _renderer.valid( ));
-            _renderer->setGraphicsThreadDoesCull( false );
         }
     }
 }
@@ -615,10 +1144,11 @@ void Channel::__applyColorMask( osg::Camera* camera ) const
         colorMask.red, colorMask.green, colorMask.blue, true );
 }
 
-void Channel::__applyViewport( osg::Camera* camera ) const
+void Channel::__applyViewport( osg::Camera* camera, float scale ) const
 {
     const eq::PixelViewport& pvp = getPixelViewport( );
-    camera->setViewport( pvp.x, pvp.y, pvp.w, pvp.h );
+    camera->setViewport( pvp.x, pvp.y, std::max( 1, int32_t( pvp.w * scale )),
+        std::max( 1, int32_t( pvp.h * scale )));
 }
 
 void Channel::__applyFrustum( osg::Camera* camera ) const
@@ -640,6 +1170,32 @@ void Channel::__applyFrustum( osg::Camera* camera ) const
 #endif
 }
 
+void Channel::__applyLODScale( osg::Camera* camera ) const
+{
+    float scale = _lodFactor;
+
+    // Channels less dense than the reference use coarser levels
+    if(( _lodDensity > 0.f ) && !useOrtho( ))
+    {
+        const eq::Frustumf& frustum = getFrustum( );
+        const eq::PixelViewport& pvp = getPixelViewport( );
+        const float near = frustum.near_plane( );
+
+        const float fovX = osg::RadiansToDegrees( atan( frustum.right( ) /
+            near ) - atan( frustum.left( ) / near ));
+        const float fovY = osg::RadiansToDegrees( atan( frustum.top( ) /
+            near ) - atan( frustum.bottom( ) / near ));
+        if(( fovX > 0.f ) && ( fovY > 0.f ) && pvp.hasArea( ))
+        {
+            const float density = sqrt( pvp.w / fovX * pvp.h / fovY );
+            scale *= osg::clampBetween( _lodDensity / density, 1.f,
+                LOD_SCALE_MAX );
+        }
+    }
+
+    camera->setLODScale( scale );
+}
+
 void Channel::__applyPerspective( osg::Camera* camera ) const
 {
     eq::Frustumf frustum = getPerspective( );
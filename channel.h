@@ -2,13 +2,17 @@
 
 #include <eq/eq.h>
 
+#include "depthCompositor.h"
+#include "frameStats.h"
 #include "viewer.h"
+#include "renderer.h"
 
 #include <osg/Camera>
 #include <osgViewer/Viewer>
 #include <osgViewer/Renderer>
 
 #include <osgEarthUtil/Controls>
+#include <osgEarthUtil/LogarithmicDepthBuffer>
 
 #define CONTROLS
 
@@ -35,8 +39,10 @@ protected:
 #if 0
     virtual void frameStart( const eq::uint128_t& frameID,
         const uint32_t frameNumber );
+#endif
     virtual void frameFinish( const eq::uint128_t& frameID,
         const uint32_t frameNumber );
+#if 0
     virtual void frameDrawFinish( const eq::uint128_t& frameID,
         const uint32_t frameNumber );
 #endif
@@ -52,14 +58,59 @@ protected:
     virtual bool useOrtho( ) const { return false; }
 
 protected:
+    typedef std::map< eq::uint128_t, osg::ref_ptr< osg::Camera > > CameraMap;
+
     eq::uint128_t _sceneID;
     osg::ref_ptr< osg::Camera > _camera;
-    osg::ref_ptr< osgViewer::Renderer > _renderer;
+    osg::ref_ptr< Renderer > _renderer;
+    CameraMap _cameras; // one camera (and its renderer) per scene
+    osgEarth::Util::LogarithmicDepthBuffer* _logDepthBuffer; // --depth log
 
     eq::uint128_t _overlayID;
     osg::ref_ptr< osgViewer::Viewer > _viewer2d;
     osg::ref_ptr< osgEarth::Util::Controls::ControlCanvas > _camera2d;
 
+    FrameStats _stats;
+
+    float _lodDensity; // see InitData::setLODDensity
+    float _lodFactor; // "lod=<factor>" in the channel name
+
+    // Dynamic resolution, see InitData::setTargetFPS
+    float _targetDrawTime; // ms, 0 if disabled
+    float _resolution; // of the next draw, ( 0, 1 ]
+    GLuint _upsampleTexture;
+    eq::PixelViewport _upsampleSize;
+    GLuint _drawQueries[2]; // GL_TIME_ELAPSED of this and the last draw
+    uint32_t _drawQuery; // of this draw
+    uint32_t _numDrawQueries; // issued, up to 2
+    lunchbox::Clock _frameClock; // without timer queries
+
+    void upsample( );
+    void beginDrawQuery( );
+    float endDrawQuery( );
+    void updateResolution( const float drawTime );
+
+    // Output frames, see InitData::setCompression
+    int32_t _compression;
+    bool _dropAlpha;
+    eq::Image _transportImage; // a copy of the output, compressed for stats
+    eq::Image _receivedImage; // and decompressed again
+
+    void addTransportStats( );
+
+    // CPU compositing, see InitData::setCompositeThreads
+    uint32_t _compositeThreads;
+    DepthCompositor* _compositor;
+
+    bool compositeFrames( );
+
+    // Overlay pointer motion, only the last one per frame is queued
+    bool _motionPending;
+    uint32_t _motionX, _motionY;
+    double _motionTime;
+
+    void queuePendingMotion( );
+    void addCullStats( );
     void updateView( );
     void windowPick( uint32_t x, uint32_t y ) const;
     void worldPick( const eq::Vector3d& origin,
@@ -68,13 +119,18 @@ protected:
 private:
     void cleanup( );
 
+    osg::Camera* createCamera( );
+    void releaseCameras( );
+    void releaseRenderer( );
+
     void connectCameraToScene( const eq::uint128_t& id );
     void connectCameraToOverlay( const eq::uint128_t& id );
 
     void __applyBuffer( osg::Camera* camera );
     void __applyColorMask( osg::Camera* camera ) const;
-    void __applyViewport( osg::Camera* camera ) const;
+    void __applyViewport( osg::Camera* camera, float scale = 1.f ) const;
     void __applyFrustum( osg::Camera* camera ) const;
+    void __applyLODScale( osg::Camera* camera ) const;
     void __applyPerspective( osg::Camera* camera ) const;
     void __applyOrtho( osg::Camera* camera ) const;
 
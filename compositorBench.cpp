@@ -0,0 +1,231 @@
+// DepthCompositor on synthetic DB frames at 1080p and 4K: 2 to 8 full
+// frames of random depth merged by 1 to 8 threads, checked against a plain
+// per-pixel merge. Then offset, partially overlapping and differently sized
+// images as direct-send tiles produce them, checked the same way. Needs no
+// GPU.
+
+#include "depthCompositor.h"
+
+#include <lunchbox/clock.h>
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#define NUM_FRAMES 50
+#define MAX_SOURCES 8
+#define MAX_THREADS 8
+
+using namespace eqEarth;
+
+struct Source
+{
+    std::vector< uint32_t > color;
+    std::vector< uint32_t > depth;
+};
+
+// Depth in large runs like the surface of the globe, with some background
+static void fill( Source& source, const size_t numPixels, const uint32_t id )
+{
+    source.color.assign( numPixels, id );
+    source.depth.resize( numPixels );
+
+    uint32_t depth = 0xffffffffu;
+    for( size_t i = 0; i < numPixels; ++i )
+    {
+        if( rand( ) % 64 == 0 )
+            depth = ( rand( ) % 8 == 0 ) ? 0xffffffffu :
+                uint32_t( rand( )) << 1;
+        source.depth[i] = depth;
+    }
+}
+
+static bool check( const DepthCompositor& compositor,
+    const std::vector< Source >& sources, const uint32_t numSources,
+    const size_t numPixels )
+{
+    const uint32_t* color = compositor.getColor( );
+    const uint32_t* depth = compositor.getDepth( );
+    for( size_t i = 0; i < numPixels; ++i )
+    {
+        uint32_t nearColor = 0;
+        uint32_t nearDepth = 0xffffffffu;
+        for( uint32_t j = 0; j < numSources; ++j )
+        {
+            if( sources[j].depth[i] < nearDepth )
+            {
+                nearDepth = sources[j].depth[i];
+                nearColor = sources[j].color[i];
+            }
+        }
+        if( depth[i] != nearDepth || color[i] != nearColor )
+            return false;
+    }
+    return true;
+}
+
+// An image of a layout, at x, y of the result
+struct Tile
+{
+    int32_t x, y, width, height;
+};
+
+static const Tile _tiles[] =
+{
+    // direct-send tiles of a frame at an offset, rows not a multiple of
+    // the bands
+    { 100, 50, 1920, 270 }, { 100, 320, 1920, 270 },
+    { 100, 590, 1920, 270 }, { 100, 860, 1920, 270 },
+    // partial overlaps, odd widths and a negative origin
+    { 0, 0, 640, 480 }, { 300, 200, 501, 333 }, { -50, 400, 203, 100 },
+    { 600, 7, 37, 500 },
+    // apart, with background in between
+    { 0, 0, 100, 100 }, { 200, 150, 100, 99 }
+};
+
+static const struct
+{
+    const char* name;
+    size_t first, count; // of _tiles
+} _layouts[] =
+{
+    { "tiles", 0, 4 },
+    { "overlaps", 4, 4 },
+    { "apart", 8, 2 }
+};
+
+// Every pixel of the result, nearest of the images covering it in the order
+// they were added, else the far plane
+static bool checkLayout( const DepthCompositor& compositor,
+    const Tile* tiles, const std::vector< Source >& sources,
+    const size_t numTiles )
+{
+    const int32_t w = compositor.getWidth( );
+    const int32_t h = compositor.getHeight( );
+    for( int32_t y = 0; y < h; ++y )
+    {
+        for( int32_t x = 0; x < w; ++x )
+        {
+            const int32_t rx = x + compositor.getX( );
+            const int32_t ry = y + compositor.getY( );
+
+            uint32_t nearColor = 0;
+            uint32_t nearDepth = 0xffffffffu;
+            for( size_t i = 0; i < numTiles; ++i )
+            {
+                const Tile& tile = tiles[i];
+                if( rx < tile.x || rx >= tile.x + tile.width ||
+                    ry < tile.y || ry >= tile.y + tile.height )
+                    continue;
+
+                const size_t j = size_t( ry - tile.y ) * tile.width +
+                    ( rx - tile.x );
+                if( sources[i].depth[j] < nearDepth )
+                {
+                    nearDepth = sources[i].depth[j];
+                    nearColor = sources[i].color[j];
+                }
+            }
+
+            const size_t k = size_t( y ) * w + x;
+            if( compositor.getDepth( )[k] != nearDepth ||
+                compositor.getColor( )[k] != nearColor )
+                return false;
+        }
+    }
+    return true;
+}
+
+static bool testLayouts( )
+{
+    std::cout << "   layout  images  threads  result" << std::endl;
+
+    bool ok = true;
+    for( size_t l = 0; l < sizeof( _layouts ) / sizeof( _layouts[0] ); ++l )
+    {
+        const Tile* tiles = _tiles + _layouts[l].first;
+        const size_t numTiles = _layouts[l].count;
+
+        std::vector< Source > sources( numTiles );
+        for( size_t i = 0; i < numTiles; ++i )
+            fill( sources[i], size_t( tiles[i].width ) * tiles[i].height,
+                uint32_t( i + 1 ));
+
+        for( uint32_t numThreads = 1; numThreads <= MAX_THREADS;
+             numThreads *= 2 )
+        {
+            DepthCompositor compositor( numThreads );
+            for( size_t i = 0; i < numTiles; ++i )
+                compositor.addImage( &sources[i].color[0],
+                    &sources[i].depth[0], tiles[i].x, tiles[i].y,
+                    tiles[i].width, tiles[i].height );
+            compositor.composite( );
+
+            const bool valid =
+                checkLayout( compositor, tiles, sources, numTiles );
+            ok = ok && valid;
+
+            std::cout << std::setw( 9 ) << _layouts[l].name
+                << std::setw( 8 ) << numTiles
+                << std::setw( 9 ) << numThreads
+                << "  " << ( valid ? "ok" : "FAILED" ) << std::endl;
+        }
+    }
+    return ok;
+}
+
+int main( )
+{
+    const int32_t sizes[][2] = { { 1920, 1080 }, { 3840, 2160 }};
+
+    std::cout << "kernel " << DepthCompositor::getKernelName( ) << std::endl
+        << "     size  sources  threads  ms/frame  Mpixel/s  result"
+        << std::endl;
+
+    bool ok = true;
+    for( size_t s = 0; s < sizeof( sizes ) / sizeof( sizes[0] ); ++s )
+    {
+        const int32_t w = sizes[s][0];
+        const int32_t h = sizes[s][1];
+        const size_t numPixels = size_t( w ) * h;
+
+        std::vector< Source > sources( MAX_SOURCES );
+        for( uint32_t i = 0; i < MAX_SOURCES; ++i )
+            fill( sources[i], numPixels, i + 1 );
+
+        for( uint32_t numSources = 2; numSources <= MAX_SOURCES;
+             numSources *= 2 )
+        {
+            for( uint32_t numThreads = 1; numThreads <= MAX_THREADS;
+                 numThreads *= 2 )
+            {
+                DepthCompositor compositor( numThreads );
+
+                lunchbox::Clock clock;
+                for( uint32_t frame = 0; frame < NUM_FRAMES; ++frame )
+                {
+                    for( uint32_t i = 0; i < numSources; ++i )
+                        compositor.addImage( &sources[i].color[0],
+                            &sources[i].depth[0], 0, 0, w, h );
+                    compositor.composite( );
+                }
+                const float ms = clock.getTimef( ) / NUM_FRAMES;
+
+                const bool valid =
+                    check( compositor, sources, numSources, numPixels );
+                ok = ok && valid;
+
+                std::cout << std::fixed << std::setprecision( 2 )
+                    << std::setw( 4 ) << w << "x" << std::setw( 4 ) << h
+                    << std::setw( 8 ) << numSources
+                    << std::setw( 9 ) << numThreads
+                    << std::setw( 10 ) << ms
+                    << std::setw( 10 ) << numPixels * numSources / ms / 1000.
+                    << "  " << ( valid ? "ok" : "FAILED" ) << std::endl;
+            }
+        }
+    }
+
+    ok = testLayouts( ) && ok;
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -2,11 +2,11 @@
 
 #include "error.h"
 #include "util.h"
-#include "vps.h"
 #include "callbacks.h"
 #include "window.h" // for Window::initCapabilities
 #include "configEvent.h"
 #include "controls.h"
+#include "trace.h"
 
 #include "earthManipulator.h"
 #include <osgEarth/TerrainEngineNode>
@@ -46,6 +46,15 @@
 #define NFR_AT_RADIUS 0.00001
 #define NFR_AT_DOUBLE_RADIUS 0.0049
 
+// Logarithmic depth keeps its precision with the near plane at the camera
+#define LOG_DEPTH_NEAR 0.05
+#define LOG_DEPTH_MAX_ELEVATION 9000.0 // see mountains behind the horizon
+
+#define VIEW_BYTES_REPORT_FRAMES 100
+
+// s ahead of a moving camera the pager loads tiles for
+#define PREFETCH_LOOKAHEAD 1.0
+
 namespace eqEarth
 {
 // ----------------------------------------------------------------------------
@@ -79,6 +88,7 @@ struct Config::ViewCollector : public eq::ConfigVisitor
 {
 ViewCollector( Config* config )
     : _config( config )
+    , _slot( 0 )
 {
 }
 
@@ -87,10 +97,9 @@ virtual eq::VisitorResult visit( eq::View* view )
     View* v = static_cast< View* >( view );
     osgViewer::View* osgView;
 
-    lunchbox::uint128_t id( 1 );
-
-    v->setSceneID( id );
-    v->setOverlayID( id );
+    v->setSceneID( lunchbox::uint128_t( _config->getSceneIndex( v )));
+    v->setOverlayID( lunchbox::uint128_t( 1 ));
+    v->setSlot( _slot++ );
 
     osgView = _config->takeOrCreateOSGView( v->getSceneID( ));
 
@@ -100,15 +109,15 @@ virtual eq::VisitorResult visit( eq::View* view )
     {
         osgGA::CameraManipulator* m;
 
-        osgEarth::MapNode* map =
-            osgEarth::MapNode::findMapNode( osgView->getSceneData( ));
-        if( map )
+        const SceneDescriptor& scene =
+            CompositeViewer::getSceneDescriptor( osgView );
+        if( scene.mapNode )
         {
             EarthManipulator* em = new EarthManipulator;
-            if( !map->isGeocentric( ))
+            if( !scene.geocentric )
                 em->getSettings()->setCameraProjection(
                     EarthManipulator::PROJ_ORTHOGRAPHIC );
-            em->setNode( map->getTerrainEngine( ));
+            em->setNode( scene.mapNode->getTerrainEngine( ));
             m = em;
         }
         else
@@ -133,12 +142,36 @@ virtual eq::VisitorResult visit( eq::View* view )
 
 public:
     Config* _config;
+    uint32_t _slot;
+};
+
+// ----------------------------------------------------------------------------
+
+struct ViewLister : public eq::ConfigVisitor
+{
+ViewLister( std::vector< View* >& views )
+    : _views( views )
+{
+}
+
+virtual eq::VisitorResult visit( eq::View* view )
+{
+    _views.push_back( static_cast< View* >( view ));
+    return eq::TRAVERSE_CONTINUE;
+}
+
+std::vector< View* >& _views;
 };
 
 // ----------------------------------------------------------------------------
 
 struct ViewUpdater : public eq::ConfigVisitor
 {
+ViewUpdater( const int32_t depthMode )
+    : _depthMode( depthMode )
+{
+}
+
 virtual eq::VisitorResult visit( eq::View* view )
 {
     View* v = static_cast< View* >( view );
@@ -146,27 +179,45 @@ virtual eq::VisitorResult visit( eq::View* view )
     LBASSERT( osgView );
     const osgGA::CameraManipulator* m = osgView->getCameraManipulator( );
     LBASSERT( m );
-    const osg::Matrixd& viewMatrix = m->getInverseMatrix( );
+
+    const SceneDescriptor& scene =
+        CompositeViewer::getSceneDescriptor( osgView );
+
+    const osg::Matrixd viewMatrix = m->getInverseMatrix( );
+
+    // Views whose manipulator did not move keep their state
+    const EarthManipulator* em = scene.earthManipulator;
+    if( em &&
+        !v->setManipulatorGeneration( m, em->getGeneration( ), viewMatrix ))
+    {
+        v->clearPrefetch( );
+        return eq::TRAVERSE_CONTINUE;
+    }
     //const osg::Matrixd& viewMatrix = osgView->getCamera( )->getViewMatrix( );
 
     /* VIEW MATRIX */
     v->setViewMatrix( osgToVmml( viewMatrix ));
 
     /* NEAR/FAR */
-    osgEarth::MapNode* map = osgEarth::MapNode::findMapNode(
-        osgView->getSceneData( ));
-    if( map )
+    if( scene.mapNode )
     {
-        if( map->isGeocentric( ))
+        if( scene.geocentric )
         {
             osg::Vec3d eye, center, up;
             viewMatrix.getLookAt( eye, center, up );
             double d = eye.length( );
 
-            double rp = map->getMap( )->
-                getProfile( )->getSRS( )->getEllipsoid()->getRadiusPolar( );
+            double rp = scene.radiusPolar;
+
+            if(( d > rp ) && ( _depthMode == InitData::DEPTH_LOG ))
+            {
+                const double rm = rp + LOG_DEPTH_MAX_ELEVATION;
+                double zf = ::sqrt( d * d - rp * rp ) +
+                    ::sqrt( rm * rm - rp * rp );
 
-            if( d > rp )
+                v->setNearFar( LOG_DEPTH_NEAR, zf );
+            }
+            else if( d > rp )
             {
                 double zf = ::sqrt( d * d - rp * rp );
                 double nfr = NFR_AT_RADIUS + NFR_AT_DOUBLE_RADIUS *
@@ -190,16 +241,23 @@ virtual eq::VisitorResult visit( eq::View* view )
     }
 
     /* LAT/LON */
-    osg::ref_ptr< const osgEarth::Util::EarthManipulator > em =
-        dynamic_cast< const osgEarth::Util::EarthManipulator* >( m );
-    if( em.valid( ))
+    if( em )
     {
         const osgEarth::Util::Viewpoint& vp = em->getViewpoint( );
         v->setLatLon( vp.y( ), vp.x( ));
     }
 
+    /* PREFETCH */
+    osg::Matrixd prefetchMatrix;
+    if( em && em->getPrediction( PREFETCH_LOOKAHEAD, prefetchMatrix ))
+        v->setPrefetchMatrix( osgToVmml( prefetchMatrix ));
+    else
+        v->clearPrefetch( );
+
     return eq::TRAVERSE_CONTINUE;
 }
+
+const int32_t _depthMode;
 };
 
 // ----------------------------------------------------------------------------
@@ -208,6 +266,8 @@ Config::Config( eq::ServerPtr parent )
     : eq::Config( parent )
     , _thread_hint( true )
     , _appRenderTick( 0U )
+    , _benchmark( 0 )
+    , _cameraPath( 0 )
 {
 LBINFO << "=====> Config::Config(" << (void *)this << ")" << std::endl;
 
@@ -234,11 +294,6 @@ LBINFO << "=====> Config::Config(" << (void *)this << ")" << std::endl;
 
     _ico = new osgUtil::IncrementalCompileOperation( );
     _ico->setTargetFrameRate( 60.0f );
-
-    _pager = osgDB::DatabasePager::create( );
-    _pager->setUnrefImageDataAfterApplyPolicy( false, false );
-    if( _ico.valid( ))
-        _pager->setIncrementalCompileOperation( _ico );
 }
 
 Config::~Config( )
@@ -265,6 +320,29 @@ LBINFO << "-----> Config::init( )" << std::endl;
     if( !eq::Config::init( _initData.getID( )))
         goto out;
 
+    if( !_initData.getTraceFileName( ).empty( ))
+        Trace::enable( _initData.getTraceFileName( ), getTime( ));
+
+    if( !_initData.getBenchViewpoints( ).empty( ))
+    {
+        _benchmark = new Benchmark( _initData.getBenchViewpoints( ),
+            _initData.getBenchFrames( ));
+        if( !_benchmark->isValid( ))
+        {
+            LBERROR << "Benchmark needs at least two viewpoints" << std::endl;
+            goto out;
+        }
+    }
+
+    if( !_initData.getCameraPathFileName( ).empty( ))
+    {
+        _cameraPath = new CameraPath( _initData.getCameraPathFileName( ),
+            _initData.getReplayCameraPath( ) ? CameraPath::MODE_REPLAY :
+                CameraPath::MODE_RECORD );
+        if( !_cameraPath->isValid( ))
+            goto out;
+    }
+
     {
         ViewCollector m( this );
         accept( m );
@@ -285,6 +363,8 @@ bool Config::exit( )
 {
     bool ret = eq::Config::exit( );
 
+    Trace::write( );
+
     cleanup( );
 
     return ret;
@@ -292,12 +372,33 @@ bool Config::exit( )
 
 uint32_t Config::startFrame( )
 {
-LBINFO << "-----> Config<" << getName( ) << ">::startFrame( )" << std::endl;
+    EQEARTH_TRACE_SCOPE( "Config::startFrame", getCurrentFrame( ) + 1 );
+
+    flushMouseEvents( );
+
+    if( _benchmark && !_benchmark->frame( this ))
+        stopRunning( );
 
-    ViewUpdater m;
+    // A replayed camera path takes the place of the manipulators
+    if( !_cameraPath || !_cameraPath->isReplaying( ))
+    {
+        ViewUpdater m( _initData.getDepthMode( ));
+        accept( m );
+    }
+
+    std::vector< View* > views;
+    ViewLister m( views );
     accept( m );
 
-    const double t = static_cast< double >( getTime( )) / 1000.;
+    double t = static_cast< double >( getTime( )) / 1000.;
+    if( _cameraPath && !_cameraPath->frame( t, views ))
+        stopRunning( );
+
+    // All views go in one commit with the frame data
+    for( size_t i = 0; i < views.size( ); ++i )
+        _frameData.setViewState( views[ i ]->getSlot( ),
+            views[ i ]->getState( ));
+
     _frameData.setSimulationTime( t );
     _frameData.setCalendarTime( time( NULL ));
 
@@ -321,14 +422,12 @@ LBINFO << "-----> Config<" << getName( ) << ">::startFrame( )" << std::endl;
         }
     }
 
-LBINFO << "<----- Config<" << getName( ) << ">::startFrame( )" << std::endl;
-
     return ret;
 }
 
 uint32_t Config::finishFrame( )
 {
-LBINFO << "-----> Config<" << getName( ) << ">::finishFrame( )" << std::endl;
+    EQEARTH_TRACE_SCOPE( "Config::finishFrame", getCurrentFrame( ) );
 
     if( _viewer->getNumViews( ) > 0 )
     {
@@ -338,9 +437,27 @@ LBINFO << "-----> Config<" << getName( ) << ">::finishFrame( )" << std::endl;
     else
         _appRenderTick = 0U;
 
-LBINFO << "<----- Config<" << getName( ) << ">::finishFrame( )" << std::endl;
+    if(( getCurrentFrame( ) % VIEW_BYTES_REPORT_FRAMES ) == 0 )
+    {
+        uint64_t bytes;
+        uint32_t numSent;
+        _frameData.resetViewStatesSent( bytes, numSent );
+
+        const uint32_t numViews = _frameData.getNumViewStates( );
+        const uint64_t perFrame = bytes / VIEW_BYTES_REPORT_FRAMES;
+        LBINFO << numViews << " views, "
+            << float( numSent ) / VIEW_BYTES_REPORT_FRAMES
+            << " changed/frame, " << perFrame << " bytes/frame, "
+            << ( numSent > 0 ? bytes / numSent : 0 ) << " bytes/changed view, "
+            << ( numViews > 0 ? perFrame / numViews : 0 ) << " bytes/view"
+            << std::endl;
+    }
+
+    const uint32_t finished = eq::Config::finishFrame( );
+    if( _benchmark )
+        _benchmark->frameFinished( finished );
 
-    return eq::Config::finishFrame( );
+    return finished;
 }
 
 bool Config::mapInitData( const eq::uint128_t& initDataID )
@@ -381,7 +498,7 @@ bool Config::handleEvent( const eq::ConfigEvent* event )
                 selectCurrentView( event->data.context.view.identifier );
             if( view && _eventQueue.valid( ))
             {
-                handleMouseEvent( event, view, time );
+                queueMouseEvent( event->data, view, time );
                 ret = true;
             }
             break;
@@ -570,7 +687,7 @@ osgViewer::View* Config::takeOrCreateOSGView( const eq::uint128_t& sceneID )
         osgView = _viewer->findOSGViewByID( sceneID );
         if( osgView )
         {
-            _viewer->removeView( osgView ); // eqEarth::View still has a ref
+            _viewer->removeOSGView( osgView ); // eqEarth::View still has a ref
 
             osgView->getCamera( )->setGraphicsContext( 0 );
             osgView->getCamera( )->setViewport( 0 );
@@ -584,8 +701,9 @@ osgViewer::View* Config::takeOrCreateOSGView( const eq::uint128_t& sceneID )
         osgView->getCamera( )->setComputeNearFarMode(
             osg::CullSettings::DO_NOT_COMPUTE_NEAR_FAR );
 
-        osgView->setSceneData( getScene( sceneID, osgView ));
-        osgView->setDatabasePager( _pager );
+        const Scene& scene = getScene( sceneID, osgView );
+        osgView->setSceneData( scene.root );
+        osgView->setDatabasePager( scene.pager );
 
 #if 0
         osgEarth::Util::SkyNode* sky =
@@ -609,7 +727,7 @@ void Config::releaseOSGView( osgViewer::View* osgView )
         osgView->getCamera( )->setGraphicsContext( 0 );
         osgView->getCamera( )->setViewport( 0 );
 
-        _viewer->addView( osgView );
+        _viewer->addOSGView( osgView );
     }
 }
 
@@ -693,130 +811,172 @@ void Config::createOverlay( osgEarth::Util::Controls::ControlCanvas* cc,
 #endif
 }
 
-osg::Group* Config::getScene( const eq::uint128_t& sceneID,
-        osgViewer::View* view )
+uint32_t Config::getSceneIndex( const eq::View* view ) const
 {
-    LBASSERT( sceneID == 1 ); // TODO : multiple scenes
+    // views named "scene<N>" show the N-th model, all others the first one
+    const std::string& name = view->getName( );
+    const uint32_t numScenes = _initData.getModelFileNames( ).size( );
 
-    if( !_scene.valid( ))
+    uint32_t index = 1;
+    if( name.compare( 0, 5, "scene" ) == 0 )
+        index = atoi( name.c_str( ) + 5 );
+
+    if( index < 1 || index > numScenes )
     {
-        using namespace osgEarth;
-        //using namespace osgEarth::Drivers;
-        using namespace osgEarth::Util;
-        //using namespace osgEarth::Annotation;
+        LBWARN << "View " << name << " has no scene, using scene 1"
+            << std::endl;
+        index = 1;
+    }
+    return index;
+}
+
+const Config::Scene& Config::getScene( const eq::uint128_t& sceneID,
+        osgViewer::View* view )
+{
+    SceneMap::iterator i = _scenes.find( sceneID );
+    if( i != _scenes.end( ))
+        return i->second;
+
+    const InitData::Strings& models = _initData.getModelFileNames( );
+    LBASSERT( sceneID.high( ) == 0 );
+    LBASSERT( sceneID.low( ) >= 1 && sceneID.low( ) <= models.size( ));
+
+    Scene& scene = _scenes[ sceneID ];
+    scene.root = loadScene( models[ sceneID.low( ) - 1 ], view );
+
+    // pagers can't share threads, but keep a separate PagedLOD budget
+    // per scene so one map can't expire the tiles of another
+    scene.pager = osgDB::DatabasePager::create( );
+    scene.pager->setUnrefImageDataAfterApplyPolicy( false, false );
+    if( _initData.getSceneBudget( ) > 0 )
+        scene.pager->setTargetMaximumNumberOfPageLOD(
+            _initData.getSceneBudget( ));
+    if( _ico.valid( ))
+        scene.pager->setIncrementalCompileOperation( _ico );
+
+    LBINFO << "Loaded scene " << sceneID << " from "
+        << models[ sceneID.low( ) - 1 ] << std::endl;
 
-        osg::Group* group = new osg::Group( );
+    return scene;
+}
 
-        Map* map = NULL;
-        MapNode* mapNode = NULL;
+osg::Group* Config::loadScene( const std::string& modelFile,
+        osgViewer::View* view )
+{
+    using namespace osgEarth;
+    //using namespace osgEarth::Drivers;
+    using namespace osgEarth::Util;
+    //using namespace osgEarth::Annotation;
+
+    osg::Group* group = new osg::Group( );
+
+    Map* map = NULL;
+    MapNode* mapNode = NULL;
 
 #if 1
-        group->addChild( osgDB::readNodeFile( _initData.getModelFileName( )));
-        mapNode = osgEarth::MapNode::findMapNode( group );
-        if( mapNode )
-            map = mapNode->getMap( );
+    group->addChild( osgDB::readNodeFile( modelFile ));
+    mapNode = osgEarth::MapNode::findMapNode( group );
+    if( mapNode )
+        map = mapNode->getMap( );
 #else
-        map = new Map( );
+    map = new Map( );
 
-        TMSOptions imagery;
-        imagery.url() =
-            "http://amati-ib0.largedata.net/readymap/tiles/1.0.0/10/";
-        map->addImageLayer( new ImageLayer( "BaseImagery", imagery ));
+    TMSOptions imagery;
+    imagery.url() =
+        "http://amati-ib0.largedata.net/readymap/tiles/1.0.0/10/";
+    map->addImageLayer( new ImageLayer( "BaseImagery", imagery ));
 
-        TMSOptions elevation;
-        elevation.url() =
-            "http://amati-ib0.largedata.net/readymap/tiles/1.0.0/1/";
-        map->addElevationLayer( new ElevationLayer( "Elevation", elevation ));
+    TMSOptions elevation;
+    elevation.url() =
+        "http://amati-ib0.largedata.net/readymap/tiles/1.0.0/1/";
+    map->addElevationLayer( new ElevationLayer( "Elevation", elevation ));
 
-        mapNode = new MapNode( map );
+    mapNode = new MapNode( map );
 
-        group->addChild( mapNode );
+    group->addChild( mapNode );
 #endif
 
-        if( mapNode && map->getProfile( ) && map->isGeocentric( ))
-        {
+    if( mapNode && map->getProfile( ) && map->isGeocentric( ))
+    {
 #if 0
-            osg::ref_ptr<osgDB::Options> dbOptions =
-                Registry::instance( )->cloneOrCreateOptions( );
+        osg::ref_ptr<osgDB::Options> dbOptions =
+            Registry::instance( )->cloneOrCreateOptions( );
 #endif
 
 #if 1
-            //SkyNode* sky = new SkyNode( map );
-            SkyNode* sky = osgEarth::Util::SkyNode::create( mapNode );
+        //SkyNode* sky = new SkyNode( map );
+        SkyNode* sky = osgEarth::Util::SkyNode::create( mapNode );
 
-            sky->addUpdateCallback( new SkyUpdateCallback );
-            sky->setSunVisible( true );
-            sky->setMoonVisible( true );
-            sky->attach( view );
+        sky->addUpdateCallback( new SkyUpdateCallback );
+        sky->setSunVisible( true );
+        sky->setMoonVisible( true );
+        sky->attach( view );
 
-            group->addChild( sky );
+        group->addChild( sky );
 #endif
 
 #if 0
-            OceanNode* ocean = osgEarth::Util::OceanNode::create( mapNode );
-            group->addChild( ocean );
+        OceanNode* ocean = osgEarth::Util::OceanNode::create( mapNode );
+        group->addChild( ocean );
 #endif
 
-            const osgEarth::Util::Config& externals =
-                mapNode->externalConfig( );
+        const osgEarth::Util::Config& externals =
+            mapNode->externalConfig( );
 
-            const osgEarth::Util::Config& annoConf =
-                externals.child( "annotations" );
+        const osgEarth::Util::Config& annoConf =
+            externals.child( "annotations" );
 
 #if 0
-            if ( !annoConf.empty() )
+        if ( !annoConf.empty() )
+        {
+            osg::Group* annotations = NULL;
+            AnnotationRegistry::instance( )->create(
+                mapNode, annoConf, dbOptions.get( ), annotations );
+            if( annotations )
             {
-                osg::Group* annotations = NULL;
-                AnnotationRegistry::instance( )->create(
-                    mapNode, annoConf, dbOptions.get( ), annotations );
-                if( annotations )
-                {
-                    group->addChild( annotations );
-                }
+                group->addChild( annotations );
             }
+        }
 
 
-            const osgEarth::Util::Config& declutterConf =
-                externals.child( "decluttering" );
+        const osgEarth::Util::Config& declutterConf =
+            externals.child( "decluttering" );
 
-            if ( !declutterConf.empty() )
-            {
-                Decluttering::setOptions( DeclutteringOptions( declutterConf ));
-            }
+        if ( !declutterConf.empty() )
+        {
+            Decluttering::setOptions( DeclutteringOptions( declutterConf ));
+        }
 #endif
 
 
 #if 0
-            OceanSurfaceNode* ocean =
-                new OceanSurfaceNode( mapNode,
-                    externals.child( "ocean" ));
+        OceanSurfaceNode* ocean =
+            new OceanSurfaceNode( mapNode,
+                externals.child( "ocean" ));
 
-            group->addChild( ocean );
+        group->addChild( ocean );
 #endif
-        }
-
-        const std::string &kmlFile = _initData.getKMLFileName( );
-        if( endsWith( kmlFile, ".kml" ))
-        {
-            osg::ref_ptr<osgDB::Options> options = new osgDB::Options( );
-            options->setPluginData( "osgEarth::MapNode", mapNode );
-            osg::Node* kml = osgDB::readNodeFile( kmlFile, options.get( ));
-            if ( kml )
-                group->addChild( kml );
-        }
-
-        _scene = group;
+    }
 
-        // make sure that existing scene graph objects are allocated with
-        // thread safe ref/unref
-        _scene->setThreadSafeRefUnref( true );
+    const std::string &kmlFile = _initData.getKMLFileName( );
+    if( endsWith( kmlFile, ".kml" ))
+    {
+        osg::ref_ptr<osgDB::Options> options = new osgDB::Options( );
+        options->setPluginData( "osgEarth::MapNode", mapNode );
+        osg::Node* kml = osgDB::readNodeFile( kmlFile, options.get( ));
+        if ( kml )
+            group->addChild( kml );
     }
 
+    // make sure that existing scene graph objects are allocated with
+    // thread safe ref/unref
+    group->setThreadSafeRefUnref( true );
+
     osg::ref_ptr< osg::DisplaySettings > ds =
         osg::DisplaySettings::instance( );
-    _scene->resizeGLObjectBuffers( ds->getMaxNumberOfGraphicsContexts( ));
+    group->resizeGLObjectBuffers( ds->getMaxNumberOfGraphicsContexts( ));
 
-    return _scene.get( );
+    return group;
 }
 
 void Config::cleanup( )
@@ -826,11 +986,18 @@ void Config::cleanup( )
 
     _initData.setFrameDataID( eq::UUID::ZERO );
 
+    delete _benchmark;
+    _benchmark = 0;
+
+    delete _cameraPath;
+    _cameraPath = 0;
+
     _eventQueue = 0;
     _viewer = 0;
 
-    // Don't deref _scene until _pager threads are finished
-    _pager = 0;
+    // Don't deref scenes until pager threads are finished
+    for( SceneMap::iterator i = _scenes.begin( ); i != _scenes.end( ); ++i )
+        i->second.pager = 0;
     _ico = 0;
 
     if( osg::Referenced::getDeleteHandler( ))
@@ -839,7 +1006,7 @@ void Config::cleanup( )
         osg::Referenced::getDeleteHandler( )->flushAll( );
     }
 
-    _scene = 0;
+    _scenes.clear( );
 
     _gc = 0;
 }
@@ -855,134 +1022,170 @@ View* Config::selectCurrentView( const eq::uint128_t& viewID )
     return view;
 }
 
-//void Config::handleMouseEvent( const eq::Event& event, View* view,
-//        double time )
-void Config::handleMouseEvent( const eq::ConfigEvent* event, View* view,
-          double time )
+void Config::queueMouseEvent( const eq::Event& event, View* view,
+        double time )
 {
-    const eq::PixelViewport& pvp = event->data.context.pvp;
-    const uint32_t x = event->data.pointer.x;
-    const uint32_t y = event->data.pointer.y;
-
-    LBASSERT( _eventQueue.valid( ));
-
-    switch( event->data.type )
+    // Only the last of consecutive motions matters to the manipulators,
+    // button and wheel events are all kept
+    if( !_mouseEvents.empty( ))
     {
-        case eq::Event::WINDOW_POINTER_WHEEL:
+        MouseEvent& last = _mouseEvents.back( );
+        if(( last.view == view ) &&
+                ( last.event.originator == event.originator ) &&
+                ( last.event.type == eq::Event::CHANNEL_POINTER_MOTION ) &&
+                ( event.type == eq::Event::CHANNEL_POINTER_MOTION ))
         {
-            osgGA::GUIEventAdapter::ScrollingMotion sm =
-                osgGA::GUIEventAdapter::SCROLL_NONE;
-            if( event->data.pointer.xAxis > 0 )
-                sm = osgGA::GUIEventAdapter::SCROLL_UP;
-            else if( event->data.pointer.xAxis < 0 )
-                sm = osgGA::GUIEventAdapter::SCROLL_DOWN;
-            else if( event->data.pointer.yAxis > 0 )
-                sm = osgGA::GUIEventAdapter::SCROLL_RIGHT;
-            else if( event->data.pointer.yAxis < 0 )
-                sm = osgGA::GUIEventAdapter::SCROLL_LEFT;
-            _eventQueue->mouseScroll( sm, time );
-            break;
+            last.event = event;
+            last.time = time;
+            return;
         }
-        case eq::Event::CHANNEL_POINTER_MOTION:
-            _eventQueue->setMouseInputRange( 0, 0, pvp.w, pvp.h );
-            _eventQueue->mouseMotion( x, y, time );
-            break;
-        case eq::Event::CHANNEL_POINTER_BUTTON_PRESS:
+    }
+
+    const MouseEvent mouseEvent = { view, event, time };
+    _mouseEvents.push_back( mouseEvent );
+}
+
+void Config::flushMouseEvents( )
+{
+    MouseEvents::const_iterator begin = _mouseEvents.begin( );
+    while( begin != _mouseEvents.end( ))
+    {
+        // One camera setup for each run of events from the same channel
+        MouseEvents::const_iterator end = begin + 1;
+        while(( end != _mouseEvents.end( )) &&
+                ( end->view == begin->view ) &&
+                ( end->event.originator == begin->event.originator ))
+            ++end;
+
+        handleMouseEvents( begin->view, begin, end );
+        begin = end;
+    }
+    _mouseEvents.clear( );
+}
+
+void Config::handleMouseEvents( View* view,
+        MouseEvents::const_iterator begin, MouseEvents::const_iterator end )
+{
+    osgViewer::View* osgView = view->getOSGView( );
+    LBASSERT( osgView );
+
+    osg::ref_ptr< osgGA::EventQueue > eventQueue = osgView->getEventQueue( );
+
+    // All events of a run come from one channel, use the latest context
+    const eq::RenderContext& context = ( end - 1 )->event.context;
+    const eq::PixelViewport& pvp = context.pvp;
+
+    eventQueue->setMouseInputRange( 0, 0, pvp.w, pvp.h );
+
+    for( MouseEvents::const_iterator i = begin; i != end; ++i )
+    {
+        const eq::Event& event = i->event;
+        const double time = i->time;
+        const uint32_t x = event.pointer.x;
+        const uint32_t y = event.pointer.y;
+
+        switch( event.type )
         {
-            const unsigned int b = eqButtonToOsg( event->data.pointer.button );
-            if( b <= 3 )
+            case eq::Event::WINDOW_POINTER_WHEEL:
             {
-                _eventQueue->setMouseInputRange( 0, 0, pvp.w, pvp.h );
-                _eventQueue->mouseButtonPress( x, y, b, time );
+                osgGA::GUIEventAdapter::ScrollingMotion sm =
+                    osgGA::GUIEventAdapter::SCROLL_NONE;
+                if( event.pointer.xAxis > 0 )
+                    sm = osgGA::GUIEventAdapter::SCROLL_UP;
+                else if( event.pointer.xAxis < 0 )
+                    sm = osgGA::GUIEventAdapter::SCROLL_DOWN;
+                else if( event.pointer.yAxis > 0 )
+                    sm = osgGA::GUIEventAdapter::SCROLL_RIGHT;
+                else if( event.pointer.yAxis < 0 )
+                    sm = osgGA::GUIEventAdapter::SCROLL_LEFT;
+                eventQueue->mouseScroll( sm, time );
+                break;
             }
-            break;
-        }
-        case eq::Event::CHANNEL_POINTER_BUTTON_RELEASE:
-        {
-            const unsigned int b = eqButtonToOsg( event->data.pointer.button );
-            if( b <= 3 )
+            case eq::Event::CHANNEL_POINTER_MOTION:
+                eventQueue->mouseMotion( x, y, time );
+                break;
+            case eq::Event::CHANNEL_POINTER_BUTTON_PRESS:
             {
-                _eventQueue->setMouseInputRange( 0, 0, pvp.w, pvp.h );
-                _eventQueue->mouseButtonRelease( x, y, b, time );
+                const unsigned int b = eqButtonToOsg( event.pointer.button );
+                if( b <= 3 )
+                    eventQueue->mouseButtonPress( x, y, b, time );
+                break;
             }
-            break;
+            case eq::Event::CHANNEL_POINTER_BUTTON_RELEASE:
+            {
+                const unsigned int b = eqButtonToOsg( event.pointer.button );
+                if( b <= 3 )
+                    eventQueue->mouseButtonRelease( x, y, b, time );
+                break;
+            }
+            default:
+                break;
         }
-        default:
-            break;
     }
 
     osgGA::EventQueue::Events events;
-    _eventQueue->takeEvents( events );
+    eventQueue->takeEvents( events );
 
-    for( osgGA::EventQueue::Events::iterator itr = events.begin( );
-            itr != events.end( ); ++itr)
-    {
-        osgViewer::View* osgView = view->getOSGView( );
-        LBASSERT( osgView );
+    osg::ref_ptr< osgGA::CameraManipulator > m =
+        osgView->getCameraManipulator( );
+    if( events.empty( ) || !m.valid( ))
+        return;
 
-        osg::ref_ptr< osgGA::CameraManipulator > m =
-            osgView->getCameraManipulator( );
-        if( m.valid( ))
-        {
-            osg::ref_ptr< osg::Camera > camera = osgView->getCamera( );
+    osg::ref_ptr< osg::Camera > camera = osgView->getCamera( );
 
-            ngc->setPVP( pvp.w, pvp.h );
+    ngc->setPVP( pvp.w, pvp.h );
 
-            camera->setGraphicsContext( ngc );
+    camera->setGraphicsContext( ngc );
 
-            // viewport
-            camera->setViewport( 0, 0, pvp.w, pvp.h );
+    // viewport
+    camera->setViewport( 0, 0, pvp.w, pvp.h );
 
-            osgEarth::MapNode* map =
-                osgEarth::MapNode::findMapNode( osgView->getSceneData( ));
+    const SceneDescriptor& scene =
+        CompositeViewer::getSceneDescriptor( osgView );
 
-            if( map )
-            {
-                double near, far;
-                view->getNearFar( near, far );
-                const eq::Matrix4d& headView = view->getViewMatrix( );
+    if( scene.mapNode )
+    {
+        double near, far;
+        view->getNearFar( near, far );
+        const eq::Matrix4d& headView = view->getViewMatrix( );
 
-                if( map->isGeocentric( ))
-                {
-                    eq::Frustumf frustum = event->data.context.frustum;
-                    frustum.adjust_near( near );
-                    frustum.far_plane( ) = far;
-                    camera->setProjectionMatrixAsFrustum(
-                        frustum.left( ), frustum.right( ),
-                        frustum.bottom( ), frustum.top( ),
-                        frustum.near_plane( ), frustum.far_plane( ));
-
-                    const eq::Matrix4d& headTransform =
-                        event->data.context.headTransform;
-                    camera->setViewMatrix( vmmlToOsg( headTransform *
-                            headView ));
-                }
-                else
-                {
-                    eq::Frustumf frustum = event->data.context.ortho;
-                    frustum.adjust_near( near );
-                    frustum.far_plane( ) = far;
-                    camera->setProjectionMatrixAsOrtho(
-                        frustum.left( ), frustum.right( ),
-                        frustum.bottom( ), frustum.top( ),
-                        frustum.near_plane( ), frustum.far_plane( ));
-
-                    const eq::Matrix4d& orthoTransform =
-                        event->data.context.orthoTransform;
-                    camera->setViewMatrix( vmmlToOsg( orthoTransform *
-                            headView ));
-                }
-            }
+        if( scene.geocentric )
+        {
+            eq::Frustumf frustum = context.frustum;
+            frustum.adjust_near( near );
+            frustum.far_plane( ) = far;
+            camera->setProjectionMatrixAsFrustum(
+                frustum.left( ), frustum.right( ),
+                frustum.bottom( ), frustum.top( ),
+                frustum.near_plane( ), frustum.far_plane( ));
+
+            const eq::Matrix4d& headTransform = context.headTransform;
+            camera->setViewMatrix( vmmlToOsg( headTransform * headView ));
+        }
+        else
+        {
+            eq::Frustumf frustum = context.ortho;
+            frustum.adjust_near( near );
+            frustum.far_plane( ) = far;
+            camera->setProjectionMatrixAsOrtho(
+                frustum.left( ), frustum.right( ),
+                frustum.bottom( ), frustum.top( ),
+                frustum.near_plane( ), frustum.far_plane( ));
+
+            const eq::Matrix4d& orthoTransform = context.orthoTransform;
+            camera->setViewMatrix( vmmlToOsg( orthoTransform * headView ));
+        }
+    }
 
-            m->handleWithCheckAgainstIgnoreHandledEventsMask(
-                *itr->get( ), *osgView);
+    for( osgGA::EventQueue::Events::iterator itr = events.begin( );
+            itr != events.end( ); ++itr)
+        m->handleWithCheckAgainstIgnoreHandledEventsMask( *itr->get( ),
+            *osgView );
 
-            ngc->clearCameras( );
+    ngc->clearCameras( );
 
-            camera->setGraphicsContext( 0 );
-            camera->setViewport( 0 );
-        }
-    }
+    camera->setGraphicsContext( 0 );
+    camera->setViewport( 0 );
 }
 
 #if 0
@@ -2,6 +2,8 @@
 
 #include <eq/eq.h>
 
+#include "benchmark.h"
+#include "cameraPath.h"
 #include "initData.h"
 #include "frameData.h"
 #include "view.h"
@@ -52,7 +54,17 @@ public:
 #endif
 
 private:
-    osg::Group* getScene( const eq::uint128_t& sceneID, osgViewer::View* view );
+    struct Scene
+    {
+        osg::ref_ptr< osg::Group > root;
+        osg::ref_ptr< osgDB::DatabasePager > pager;
+    };
+
+    const Scene& getScene( const eq::uint128_t& sceneID,
+        osgViewer::View* view );
+    osg::Group* loadScene( const std::string& modelFile,
+        osgViewer::View* view );
+    uint32_t getSceneIndex( const eq::View* view ) const;
 
     void cleanup( );
 
@@ -60,10 +72,10 @@ protected:
     InitData _initData;
     FrameData _frameData;
 
-    osg::ref_ptr< osg::Group > _scene;
+    typedef stde::hash_map< eq::uint128_t, Scene > SceneMap;
+    SceneMap _scenes; // loaded on first use, each with its own pager
 
     osg::ref_ptr< osgUtil::IncrementalCompileOperation > _ico;
-    osg::ref_ptr< osgDB::DatabasePager > _pager;
 
     lunchbox::Lock _viewer_lock;
     osg::ref_ptr< CompositeViewer > _viewer;
@@ -74,12 +86,25 @@ protected:
 
     uint32_t _appRenderTick;
 
+    Benchmark* _benchmark;
+    CameraPath* _cameraPath;
+
 private:
+    struct MouseEvent
+    {
+        View* view;
+        eq::Event event;
+        double time;
+    };
+    typedef std::vector< MouseEvent > MouseEvents;
+
+    MouseEvents _mouseEvents; // since the last frame, motion coalesced
+
     View* selectCurrentView( const eq::uint128_t& viewID );
-    //void handleMouseEvent( const eq::Event& event, View* view,
-            //double time );
-    void handleMouseEvent( const eq::ConfigEvent* event, View* view,
-            double time );
+    void queueMouseEvent( const eq::Event& event, View* view, double time );
+    void flushMouseEvents( );
+    void handleMouseEvents( View* view, MouseEvents::const_iterator begin,
+            MouseEvents::const_iterator end );
 #if 0
     void updateCurrentWorldPointer( const eq::ConfigEvent& event );
 #endif
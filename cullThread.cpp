@@ -0,0 +1,56 @@
+#include "cullThread.h"
+
+#include "node.h"
+#include "renderer.h"
+
+namespace eqEarth
+{
+// ----------------------------------------------------------------------------
+
+CullThread::CullThread( const Node* node )
+    : _node( node )
+    , _pending( 0U )
+{
+}
+
+CullThread::~CullThread( )
+{
+    LBASSERT( !isRunning( ));
+}
+
+void CullThread::cull( Renderer* renderer )
+{
+    LBASSERT( renderer );
+
+    ++_pending;
+    _queue.push( renderer );
+}
+
+void CullThread::waitIdle( ) const
+{
+    _pending.waitEQ( 0U );
+}
+
+void CullThread::stop( )
+{
+    if( !isRunning( ))
+        return;
+
+    _queue.push( 0 );
+    join( );
+}
+
+void CullThread::run( )
+{
+    for( ;; )
+    {
+        Renderer* renderer = _queue.pop( );
+        if( !renderer )
+            break;
+
+        _node->cullLocked( renderer );
+
+        --_pending;
+    }
+}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <eq/eq.h>
+
+#include <lunchbox/monitor.h>
+#include <lunchbox/mtQueue.h>
+
+namespace eqEarth
+{
+class Node;
+class Renderer;
+
+/** Culls renderers of one pipe while the pipe thread draws. */
+class CullThread : public lunchbox::Thread
+{
+public:
+    CullThread( const Node* node );
+    virtual ~CullThread( );
+
+    /** Queue a cull of the renderer's camera as currently set up. */
+    void cull( Renderer* renderer );
+
+    /** Wait until all queued culls are finished. */
+    void waitIdle( ) const;
+
+    /** Finish queued culls and exit the thread. */
+    void stop( );
+
+protected:
+    virtual void run( );
+
+private:
+    const Node* const _node;
+    lunchbox::MTQueue< Renderer* > _queue;
+    lunchbox::Monitor< uint32_t > _pending;
+};
+}
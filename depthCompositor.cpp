@@ -0,0 +1,191 @@
+#include "depthCompositor.h"
+
+#include <algorithm>
+
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
+#define COMPOSITE_BAND_ROWS 16 // per task, small enough to balance threads
+#define COMPOSITE_FAR 0xffffffffu
+
+namespace eqEarth
+{
+// ----------------------------------------------------------------------------
+
+// Takes the source pixels that are nearer than the destination's
+static void _mergeSpan( uint32_t* color, uint32_t* depth,
+    const uint32_t* srcColor, const uint32_t* srcDepth, const int32_t n )
+{
+    int32_t i = 0;
+#ifdef __SSE2__
+    // SSE2 only compares signed, flipping the sign bit orders unsigned
+    const __m128i sign = _mm_set1_epi32( 0x80000000 );
+    for( ; i + 4 <= n; i += 4 )
+    {
+        const __m128i d = _mm_loadu_si128(
+            reinterpret_cast< const __m128i* >( depth + i ));
+        const __m128i s = _mm_loadu_si128(
+            reinterpret_cast< const __m128i* >( srcDepth + i ));
+        const __m128i nearer = _mm_cmplt_epi32( _mm_xor_si128( s, sign ),
+            _mm_xor_si128( d, sign ));
+
+        const __m128i c = _mm_loadu_si128(
+            reinterpret_cast< const __m128i* >( color + i ));
+        const __m128i sc = _mm_loadu_si128(
+            reinterpret_cast< const __m128i* >( srcColor + i ));
+
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( depth + i ),
+            _mm_or_si128( _mm_and_si128( nearer, s ),
+                _mm_andnot_si128( nearer, d )));
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( color + i ),
+            _mm_or_si128( _mm_and_si128( nearer, sc ),
+                _mm_andnot_si128( nearer, c )));
+    }
+#endif
+    for( ; i < n; ++i )
+    {
+        if( srcDepth[i] < depth[i] )
+        {
+            depth[i] = srcDepth[i];
+            color[i] = srcColor[i];
+        }
+    }
+}
+
+DepthCompositor::DepthCompositor( const uint32_t numThreads )
+    : _x( 0 ), _y( 0 ), _width( 0 ), _height( 0 )
+    , _color( 1, 0 )
+    , _depth( 1, COMPOSITE_FAR )
+    , _pending( 0U )
+{
+    for( uint32_t i = 1; i < numThreads; ++i )
+    {
+        Worker* worker = new Worker( this );
+        worker->start( );
+        _workers.push_back( worker );
+    }
+}
+
+DepthCompositor::~DepthCompositor( )
+{
+    for( size_t i = 0; i < _workers.size( ); ++i )
+        _bands.push( -1 );
+
+    for( size_t i = 0; i < _workers.size( ); ++i )
+    {
+        _workers[i]->join( );
+        delete _workers[i];
+    }
+}
+
+void DepthCompositor::addImage( const uint32_t* color, const uint32_t* depth,
+        const int32_t x, const int32_t y, const int32_t width,
+        const int32_t height )
+{
+    if( width <= 0 || height <= 0 )
+        return;
+
+    const Image image = { color, depth, x, y, width, height };
+    _images.push_back( image );
+}
+
+bool DepthCompositor::composite( )
+{
+    if( _images.empty( ))
+        return false;
+
+    int32_t x0 = _images[0].x;
+    int32_t y0 = _images[0].y;
+    int32_t x1 = x0 + _images[0].width;
+    int32_t y1 = y0 + _images[0].height;
+    for( size_t i = 1; i < _images.size( ); ++i )
+    {
+        const Image& image = _images[i];
+        x0 = std::min( x0, image.x );
+        y0 = std::min( y0, image.y );
+        x1 = std::max( x1, image.x + image.width );
+        y1 = std::max( y1, image.y + image.height );
+    }
+
+    _x = x0;
+    _y = y0;
+    _width = x1 - x0;
+    _height = y1 - y0;
+    _color.resize( size_t( _width ) * _height );
+    _depth.resize( size_t( _width ) * _height );
+
+    if( _workers.empty( ))
+        compositeRows( 0, _height );
+    else
+    {
+        for( int32_t row = 0; row < _height; row += COMPOSITE_BAND_ROWS )
+        {
+            ++_pending;
+            _bands.push( row );
+        }
+
+        // the calling thread takes its share, then waits for the last bands
+        int32_t row;
+        while( _bands.tryPop( row ))
+            compositeBand( row );
+        _pending.waitEQ( 0U );
+    }
+
+    _images.clear( );
+    return true;
+}
+
+const char* DepthCompositor::getKernelName( )
+{
+#ifdef __SSE2__
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+void DepthCompositor::compositeRows( const int32_t begin, const int32_t end )
+{
+    const size_t first = size_t( begin ) * _width;
+    const size_t last = size_t( end ) * _width;
+    std::fill( &_color[0] + first, &_color[0] + last, 0U );
+    std::fill( &_depth[0] + first, &_depth[0] + last, COMPOSITE_FAR );
+
+    for( size_t i = 0; i < _images.size( ); ++i )
+    {
+        const Image& image = _images[i];
+
+        // rows and columns of the image in the result
+        const int32_t top = std::max( begin, image.y - _y );
+        const int32_t bottom = std::min( end, image.y - _y + image.height );
+        const int32_t left = image.x - _x;
+
+        for( int32_t row = top; row < bottom; ++row )
+        {
+            const size_t src = size_t( row + _y - image.y ) * image.width;
+            const size_t dst = size_t( row ) * _width + left;
+            _mergeSpan( &_color[ dst ], &_depth[ dst ], image.color + src,
+                image.depth + src, image.width );
+        }
+    }
+}
+
+void DepthCompositor::compositeBand( const int32_t row )
+{
+    compositeRows( row, std::min( row + COMPOSITE_BAND_ROWS, _height ));
+    --_pending;
+}
+
+void DepthCompositor::Worker::run( )
+{
+    for( ;; )
+    {
+        const int32_t row = _compositor->_bands.pop( );
+        if( row < 0 )
+            break;
+
+        _compositor->compositeBand( row );
+    }
+}
+}
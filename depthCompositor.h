@@ -0,0 +1,88 @@
+#pragma once
+
+#include <lunchbox/monitor.h>
+#include <lunchbox/mtQueue.h>
+#include <lunchbox/thread.h>
+
+#include <vector>
+
+namespace eqEarth
+{
+/**
+ * Sort-last compositing on the CPU, for destinations whose GPU is busy
+ * drawing their own share. Merges the 32 bit color and depth of any number
+ * of images where they are nearest, in bands of rows spread across worker
+ * threads, so that the result is uploaded once. Knows nothing about OpenGL
+ * or Equalizer frames.
+ */
+class DepthCompositor
+{
+public:
+    /**
+     * The calling thread composites along with numThreads - 1 workers, 1
+     * thread composites on the calling thread alone.
+     */
+    explicit DepthCompositor( const uint32_t numThreads );
+    ~DepthCompositor( );
+
+    /**
+     * Add an image at x, y. The pixels are read by the next composite and
+     * must stay valid until then. Smaller depth values are nearer.
+     */
+    void addImage( const uint32_t* color, const uint32_t* depth,
+        const int32_t x, const int32_t y, const int32_t width,
+        const int32_t height );
+
+    /**
+     * Merge the added images into one covering all of them, pixels of none
+     * of them are at the far plane. Drops the images afterwards.
+     * @return false if there were none.
+     */
+    bool composite( );
+
+    /** The result of the last composite, row by row. */
+    int32_t getX( ) const { return _x; }
+    int32_t getY( ) const { return _y; }
+    int32_t getWidth( ) const { return _width; }
+    int32_t getHeight( ) const { return _height; }
+    const uint32_t* getColor( ) const { return &_color[0]; }
+    const uint32_t* getDepth( ) const { return &_depth[0]; }
+
+    /** @return the name of the depth compare kernel compiled in. */
+    static const char* getKernelName( );
+
+private:
+    struct Image
+    {
+        const uint32_t* color;
+        const uint32_t* depth;
+        int32_t x, y, width, height;
+    };
+
+    class Worker : public lunchbox::Thread
+    {
+    public:
+        Worker( DepthCompositor* compositor ) : _compositor( compositor ) {}
+
+    protected:
+        virtual void run( );
+
+    private:
+        DepthCompositor* const _compositor;
+    };
+    friend class Worker;
+
+    std::vector< Image > _images;
+
+    int32_t _x, _y, _width, _height;
+    std::vector< uint32_t > _color;
+    std::vector< uint32_t > _depth;
+
+    std::vector< Worker* > _workers;
+    lunchbox::MTQueue< int32_t > _bands; // first row, < 0 stops a worker
+    lunchbox::Monitor< uint32_t > _pending;
+
+    void compositeRows( const int32_t begin, const int32_t end );
+    void compositeBand( const int32_t row );
+};
+}
@@ -1,10 +1,48 @@
 #include "earthManipulator.h"
 
+#include <osgEarth/SpatialReference>
+
+// A prediction moving less than this share of the distance to the focal
+// point is no prediction
+#define PREDICTION_MIN_MOVE 0.01
+// Zooming in must not predict the eye below this share of its altitude
+#define PREDICTION_MIN_ALTITUDE 0.5
+
 namespace eqEarth
 {
 // ----------------------------------------------------------------------------
 
+// Looking at the focal point from range, heading and pitch in its local
+// east/north/up frame
+static bool _getViewMatrix( const osgEarth::Viewpoint& vp,
+    const osgEarth::SpatialReference* srs, osg::Matrixd& viewMatrix )
+{
+    if( vp.getSRS( ))
+        srs = vp.getSRS( );
+    if( !srs )
+        return false;
+
+    osg::Vec3d focal;
+    osg::Matrixd localToWorld;
+    if( !srs->transformToWorld( osg::Vec3d( vp.x( ), vp.y( ), vp.z( )),
+            focal ) ||
+        !srs->createLocalToWorld( focal, localToWorld ))
+        return false;
+
+    const double h = osg::DegreesToRadians( vp.getHeading( ));
+    const double p = osg::DegreesToRadians( vp.getPitch( ));
+    const osg::Vec3d look( cos( p ) * sin( h ), cos( p ) * cos( h ), sin( p ));
+    const osg::Vec3d up( -sin( p ) * sin( h ), -sin( p ) * cos( h ), cos( p ));
+
+    viewMatrix = osg::Matrixd::lookAt( -look * vp.getRange( ) * localToWorld,
+        focal, osg::Matrixd::transform3x3( up, localToWorld ));
+    return true;
+}
+
 EarthManipulator::EarthManipulator( )
+    : _generation( 1 )
+    , _hasTarget( false )
+    , _time( 0. )
 {
     overrideDefaultSettings( );
 }
@@ -13,6 +51,88 @@ EarthManipulator::~EarthManipulator( )
 {
 }
 
+bool EarthManipulator::handle( const osgGA::GUIEventAdapter& ea,
+        osgGA::GUIActionAdapter& aa )
+{
+    // Frame events only move the camera during transitions
+    if( ea.getEventType( ) != osgGA::GUIEventAdapter::FRAME )
+    {
+        ++_generation;
+
+        // Actions, e.g. GOTO, start their transitions with the base class'
+        // setViewpoint, which is not virtual, and stop ours
+        const bool handled =
+            osgEarth::Util::EarthManipulator::handle( ea, aa );
+        if( handled )
+            _hasTarget = false;
+        return handled;
+    }
+
+    const osg::Matrixd matrix = getMatrix( );
+    const bool handled = osgEarth::Util::EarthManipulator::handle( ea, aa );
+    if( getMatrix( ) != matrix )
+        ++_generation;
+
+    // The eye moves between frames, by input events or transitions
+    const osg::Vec3d eye = getMatrix( ).getTrans( );
+    const double time = ea.getTime( );
+    if(( _time > 0. ) && ( time > _time ))
+        _velocity = ( eye - _eye ) / ( time - _time );
+    _eye = eye;
+    _time = time;
+
+    return handled;
+}
+
+void EarthManipulator::setViewpoint( const osgEarth::Viewpoint& vp,
+        double duration_s )
+{
+    ++_generation;
+    osgEarth::Util::EarthManipulator::setViewpoint( vp, duration_s );
+    _target = vp;
+    _hasTarget = true;
+}
+
+void EarthManipulator::setByMatrix( const osg::Matrixd& matrix )
+{
+    ++_generation;
+    _hasTarget = false;
+    osgEarth::Util::EarthManipulator::setByMatrix( matrix );
+}
+
+void EarthManipulator::setByInverseMatrix( const osg::Matrixd& matrix )
+{
+    ++_generation;
+    _hasTarget = false;
+    osgEarth::Util::EarthManipulator::setByInverseMatrix( matrix );
+}
+
+bool EarthManipulator::getPrediction( const double lookahead,
+        osg::Matrixd& viewMatrix ) const
+{
+    if( isSettingViewpoint( ) && _hasTarget )
+        return _getViewMatrix( _target, getSRS( ), viewMatrix );
+
+    osg::Vec3d move = _velocity * lookahead;
+
+    const osgEarth::SpatialReference* srs = getSRS( );
+    if( srs && srs->isGeographic( ))
+    {
+        const double radius = srs->getEllipsoid( )->getRadiusPolar( );
+        const double altitude = _eye.length( ) - radius;
+        const double descent = altitude - (( _eye + move ).length( ) - radius );
+        const double maxDescent = altitude * ( 1. - PREDICTION_MIN_ALTITUDE );
+        if(( altitude > 0. ) && ( descent > maxDescent ))
+            move *= maxDescent / descent;
+    }
+
+    if( move.length( ) < getDistance( ) * PREDICTION_MIN_MOVE )
+        return false;
+
+    viewMatrix = osg::Matrixd::translate( -move ) * getInverseMatrix( );
+    return true;
+}
+
 void EarthManipulator::overrideDefaultSettings( )
 {
     //osg::ref_ptr< Settings > settings = new Settings( );
@@ -9,10 +9,38 @@ class EarthManipulator : public osgEarth::Util::EarthManipulator
 public:
     EarthManipulator( );
 
+    /** Changes whenever the camera may have moved. */
+    uint32_t getGeneration( ) const { return _generation; }
+
+    using osgEarth::Util::EarthManipulator::handle;
+    virtual bool handle( const osgGA::GUIEventAdapter& ea,
+        osgGA::GUIActionAdapter& aa );
+    virtual void setViewpoint( const osgEarth::Viewpoint& vp,
+        double duration_s = 0.0 );
+    virtual void setByMatrix( const osg::Matrixd& matrix );
+    virtual void setByInverseMatrix( const osg::Matrixd& matrix );
+
+    /**
+     * The view matrix lookahead seconds from now: the target of a viewpoint
+     * transition started by setViewpoint, else the eye moved on at its
+     * velocity, also during transitions of the base class' actions.
+     * @return false if the camera does not move.
+     */
+    bool getPrediction( const double lookahead,
+        osg::Matrixd& viewMatrix ) const;
+
 protected:
     ~EarthManipulator( );
 
 private:
+    uint32_t _generation;
+
+    osgEarth::Viewpoint _target; // of the last setViewpoint
+    bool _hasTarget; // the transition in progress goes to _target
+    osg::Vec3d _eye; // at _time
+    double _time;
+    osg::Vec3d _velocity;
+
     void overrideDefaultSettings( );
 };
 }
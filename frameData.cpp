@@ -4,11 +4,75 @@ namespace eqEarth
 {
 // ----------------------------------------------------------------------------
 
+ViewState::ViewState( )
+    : pose( eq::Matrix4f::IDENTITY )
+    , near( 0.01 ), far( 100.0 )
+    , lat( 0.0 ), lon( 0.0 )
+    , prefetch( false )
+    , viewMatrix( eq::Matrix4f::IDENTITY )
+{
+}
+
+bool ViewState::operator != ( const ViewState& rhs ) const
+{
+    return pose.position != rhs.pose.position ||
+        !pose.hasOrientation( rhs.pose ) ||
+        near != rhs.near || far != rhs.far ||
+        lat != rhs.lat || lon != rhs.lon ||
+        prefetch != rhs.prefetch || ( prefetch &&
+            ( prefetchPose.position != rhs.prefetchPose.position ||
+              !prefetchPose.hasOrientation( rhs.prefetchPose )));
+}
+
+static uint64_t _serializeViewState( co::DataOStream& os,
+        const ViewState& state )
+{
+    const Pose& pose = state.pose;
+    os << pose.position << pose.orientation[0] << pose.orientation[1]
+        << pose.orientation[2] << pose.orientation[3]
+        << state.near << state.far << state.lat << state.lon
+        << state.prefetch;
+    uint64_t bytes = sizeof( pose.position ) + sizeof( pose.orientation ) +
+        4 * sizeof( double ) + sizeof( bool );
+
+    if( state.prefetch )
+    {
+        const Pose& prefetch = state.prefetchPose;
+        os << prefetch.position << prefetch.orientation[0]
+            << prefetch.orientation[1] << prefetch.orientation[2]
+            << prefetch.orientation[3];
+        bytes += sizeof( prefetch.position ) + sizeof( prefetch.orientation );
+    }
+    return bytes;
+}
+
+static void _deserializeViewState( co::DataIStream& is, ViewState& state )
+{
+    Pose& pose = state.pose;
+    is >> pose.position >> pose.orientation[0] >> pose.orientation[1]
+        >> pose.orientation[2] >> pose.orientation[3]
+        >> state.near >> state.far >> state.lat >> state.lon
+        >> state.prefetch;
+    state.viewMatrix = pose.getViewMatrix( );
+
+    if( state.prefetch )
+    {
+        Pose& prefetch = state.prefetchPose;
+        is >> prefetch.position >> prefetch.orientation[0]
+            >> prefetch.orientation[1] >> prefetch.orientation[2]
+            >> prefetch.orientation[3];
+    }
+}
+
+// ----------------------------------------------------------------------------
+
 FrameData::FrameData( )
     : _simulationTime( 0. )
     , _calendarTime( (time_t)0 )
     , _currentViewID( eq::UUID::ZERO )
     , _statistics( true )
+    , _viewBytesSent( 0 )
+    , _viewStatesSent( 0 )
 {
 }
 
@@ -45,6 +109,43 @@ void FrameData::toggleStatistics( )
     setDirty( DIRTY_FLAGS );
 }
 
+void FrameData::setViewState( const uint32_t slot, const ViewState& state )
+{
+    if( !isDirty( DIRTY_VIEWSTATES ))
+    {
+        for( size_t i = 0; i < _changedViewStates.size( ); ++i )
+            _isViewStateChanged[ _changedViewStates[ i ]] = false;
+        _changedViewStates.clear( );
+    }
+
+    if( slot >= _viewStates.size( ))
+    {
+        _viewStates.resize( slot + 1 );
+        _isViewStateChanged.resize( slot + 1, false );
+    }
+
+    if( _viewStates[ slot ] != state )
+    {
+        _viewStates[ slot ] = state;
+        setDirty( DIRTY_VIEWSTATES );
+
+        // once per slot however often it changes before the commit
+        if( !_isViewStateChanged[ slot ])
+        {
+            _isViewStateChanged[ slot ] = true;
+            _changedViewStates.push_back( slot );
+        }
+    }
+}
+
+void FrameData::resetViewStatesSent( uint64_t& bytes, uint32_t& numStates )
+{
+    bytes = _viewBytesSent;
+    numStates = _viewStatesSent;
+    _viewBytesSent = 0;
+    _viewStatesSent = 0;
+}
+
 void FrameData::serialize( co::DataOStream& os, const uint64_t dirtyBits )
 {
     co::Serializable::serialize( os, dirtyBits );
@@ -55,6 +156,31 @@ void FrameData::serialize( co::DataOStream& os, const uint64_t dirtyBits )
         os << _currentViewID;
     if( dirtyBits & DIRTY_FLAGS )
         os << _statistics;
+    if( dirtyBits & DIRTY_VIEWSTATES )
+    {
+        // all states for new instances, the changed ones for deltas
+        const uint32_t numViewStates = _viewStates.size( );
+        const bool all = ( dirtyBits == DIRTY_ALL );
+        const uint32_t numChanged =
+            all ? numViewStates : _changedViewStates.size( );
+
+        os << numViewStates << numChanged;
+        uint64_t bytes = sizeof( numViewStates ) + sizeof( numChanged );
+        for( uint32_t i = 0; i < numChanged; ++i )
+        {
+            const uint32_t slot = all ? i : _changedViewStates[ i ];
+            os << slot;
+            bytes += sizeof( slot ) +
+                _serializeViewState( os, _viewStates[ slot ]);
+        }
+
+        // what the commits cost per frame, not the instance data
+        if( !all )
+        {
+            _viewBytesSent += bytes;
+            _viewStatesSent += numChanged;
+        }
+    }
 }
 
 void FrameData::deserialize( co::DataIStream& is, const uint64_t dirtyBits )
@@ -67,5 +193,20 @@ void FrameData::deserialize( co::DataIStream& is, const uint64_t dirtyBits )
         is >> _currentViewID;
     if( dirtyBits & DIRTY_FLAGS )
         is >> _statistics;
+    if( dirtyBits & DIRTY_VIEWSTATES )
+    {
+        uint32_t numViewStates, numChanged;
+        is >> numViewStates >> numChanged;
+        if( numViewStates != _viewStates.size( ))
+            _viewStates.resize( numViewStates );
+
+        for( uint32_t i = 0; i < numChanged; ++i )
+        {
+            uint32_t slot;
+            is >> slot;
+            LBASSERT( slot < numViewStates );
+            _deserializeViewState( is, _viewStates[ slot ]);
+        }
+    }
 }
 }
@@ -2,8 +2,27 @@
 
 #include <eq/eq.h>
 
+#include "pose.h"
+
 namespace eqEarth
 {
+/** Camera state of one view, all views go with the frame data. */
+struct ViewState
+{
+    ViewState( );
+
+    bool operator != ( const ViewState& rhs ) const;
+
+    Pose pose;
+    double near, far;
+    double lat, lon;
+
+    bool prefetch; // whether the pager should load ahead for prefetchPose
+    Pose prefetchPose;
+
+    eq::Matrix4f viewMatrix; // decoded pose, not distributed
+};
+
 class FrameData : public co::Serializable
 {
 public:
@@ -21,15 +40,28 @@ public:
     void toggleStatistics( );
     bool useStatistics( ) const { return _statistics; }
 
+    /** Set the state of the view in the given slot, grows as needed. */
+    void setViewState( const uint32_t slot, const ViewState& state );
+    const ViewState& getViewState( const uint32_t slot ) const
+        { return _viewStates[ slot ]; }
+    uint32_t getNumViewStates( ) const { return _viewStates.size( ); }
+
+    /**
+     * The view state bytes and states of the delta commits since the last
+     * call, without the full instance data of new mappings.
+     */
+    void resetViewStatesSent( uint64_t& bytes, uint32_t& numStates );
+
 protected:
     virtual void serialize( co::DataOStream& os, const uint64_t dirtyBits );
     virtual void deserialize( co::DataIStream& is, const uint64_t dirtyBits );
 
     enum DirtyBits
     {
-        DIRTY_TIME    = co::Serializable::DIRTY_CUSTOM << 0,
-        DIRTY_VIEW    = co::Serializable::DIRTY_CUSTOM << 1,
-        DIRTY_FLAGS   = co::Serializable::DIRTY_CUSTOM << 2
+        DIRTY_TIME       = co::Serializable::DIRTY_CUSTOM << 0,
+        DIRTY_VIEW       = co::Serializable::DIRTY_CUSTOM << 1,
+        DIRTY_FLAGS      = co::Serializable::DIRTY_CUSTOM << 2,
+        DIRTY_VIEWSTATES = co::Serializable::DIRTY_CUSTOM << 3
     };
 
     virtual ChangeType getChangeType( ) const { return DELTA; }
@@ -39,5 +71,11 @@ private:
     time_t _calendarTime;
     eq::uint128_t _currentViewID;
     bool _statistics;
+
+    std::vector< ViewState > _viewStates; // indexed by View::getSlot
+    std::vector< uint32_t > _changedViewStates; // since the last commit
+    std::vector< bool > _isViewStateChanged; // slots in the above
+    uint64_t _viewBytesSent;
+    uint32_t _viewStatesSent;
 };
 }
@@ -0,0 +1,233 @@
+#include "frameStats.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+
+namespace eqEarth
+{
+// ----------------------------------------------------------------------------
+
+static const char* const _stageNames[ FrameStats::STAGE_ALL ] =
+{
+    "event", "update", "pager_merge", "cull", "draw", "readback",
+    "compress", "decompress", "assemble", "swap"
+};
+
+static const char* const _counterNames[ FrameStats::COUNTER_ALL ] =
+{
+    "horizon_tiles", "horizon_nodes", "range_nodes", "raw_bytes",
+    "compressed_bytes"
+};
+
+static lunchbox::Lock _fileLock; // protects all of the below
+static std::ofstream* _file = 0;
+static bool _json = false;
+static uint32_t _window = 0;
+
+bool FrameStats::_enabled = false;
+
+FrameStats::FrameStats( )
+    : _numFrames( 0U )
+{
+    std::fill( _times, _times + STAGE_ALL, 0.f );
+    std::fill( _counts, _counts + COUNTER_ALL, 0U );
+    std::fill( _windowCounts, _windowCounts + COUNTER_ALL, 0U );
+}
+
+void FrameStats::add( const Stage stage, const float time )
+{
+    if( !_enabled )
+        return;
+
+    LBASSERT( stage < STAGE_ALL );
+
+    lunchbox::ScopedWrite _mutex( _lock );
+    _times[ stage ] += time;
+}
+
+void FrameStats::count( const Counter counter, const uint32_t n )
+{
+    if( !_enabled )
+        return;
+
+    LBASSERT( counter < COUNTER_ALL );
+
+    lunchbox::ScopedWrite _mutex( _lock );
+    _counts[ counter ] += n;
+}
+
+void FrameStats::finish( const uint32_t frameNumber )
+{
+    if( !_enabled )
+        return;
+
+    float times[ STAGE_ALL ];
+    uint32_t counts[ COUNTER_ALL ];
+    uint64_t windowCounts[ COUNTER_ALL ];
+    bool report = false;
+    {
+        lunchbox::ScopedWrite _mutex( _lock );
+
+        std::copy( _times, _times + STAGE_ALL, times );
+        std::fill( _times, _times + STAGE_ALL, 0.f );
+        std::copy( _counts, _counts + COUNTER_ALL, counts );
+        std::fill( _counts, _counts + COUNTER_ALL, 0U );
+
+        if( _window > 0 )
+        {
+            const uint32_t slot = _numFrames % _window;
+            for( uint32_t i = 0; i < STAGE_ALL; ++i )
+            {
+                if( _history[ i ].size( ) < _window )
+                    _history[ i ].push_back( times[ i ] );
+                else
+                    _history[ i ][ slot ] = times[ i ];
+            }
+            for( uint32_t i = 0; i < COUNTER_ALL; ++i )
+                _windowCounts[ i ] += counts[ i ];
+
+            report = ((( _numFrames + 1 ) % _window ) == 0 );
+            if( report )
+            {
+                std::copy( _windowCounts, _windowCounts + COUNTER_ALL,
+                    windowCounts );
+                std::fill( _windowCounts, _windowCounts + COUNTER_ALL, 0U );
+            }
+        }
+        ++_numFrames;
+    }
+
+    if( _file )
+    {
+        std::ostringstream row;
+        row << std::fixed << std::setprecision( 3 );
+        if( _json )
+        {
+            row << "{\"name\":\"" << _name << "\",\"frame\":" << frameNumber;
+            for( uint32_t i = 0; i < STAGE_ALL; ++i )
+                row << ",\"" << _stageNames[ i ] << "\":" << times[ i ];
+            for( uint32_t i = 0; i < COUNTER_ALL; ++i )
+                row << ",\"" << _counterNames[ i ] << "\":" << counts[ i ];
+            row << "}";
+        }
+        else
+        {
+            row << _name << "," << frameNumber;
+            for( uint32_t i = 0; i < STAGE_ALL; ++i )
+                row << "," << times[ i ];
+            for( uint32_t i = 0; i < COUNTER_ALL; ++i )
+                row << "," << counts[ i ];
+        }
+
+        lunchbox::ScopedWrite _mutex( _fileLock );
+        if( _file )
+            *_file << row.str( ) << std::endl;
+    }
+
+    if( report )
+    {
+        std::ostringstream line;
+        line << std::fixed << std::setprecision( 2 );
+        for( uint32_t i = 0; i < STAGE_ALL; ++i )
+        {
+            const Stage stage = static_cast< Stage >( i );
+            const float p99 = getPercentile( stage, 99.f );
+            if( p99 > 0.f )
+                line << " " << _stageNames[ i ] << " "
+                    << getPercentile( stage, 50.f ) << "/"
+                    << getPercentile( stage, 95.f ) << "/" << p99;
+        }
+        LBINFO << "Stats<" << _name << "> p50/p95/p99 ms:" << line.str( )
+            << std::endl;
+
+        std::ostringstream counters;
+        for( uint32_t i = 0; i < COUNTER_ALL; ++i )
+            if( windowCounts[ i ] > 0 )
+                counters << " " << _counterNames[ i ] << " "
+                    << windowCounts[ i ] / _window;
+        if( !counters.str( ).empty( ))
+            LBINFO << "Stats<" << _name << "> per frame:" << counters.str( )
+                << std::endl;
+    }
+}
+
+float FrameStats::getPercentile( const Stage stage,
+        const float percentile ) const
+{
+    LBASSERT( stage < STAGE_ALL );
+
+    std::vector< float > times;
+    {
+        lunchbox::ScopedWrite _mutex( _lock );
+        times = _history[ stage ];
+    }
+
+    if( times.empty( ))
+        return 0.f;
+
+    const size_t n = std::min( times.size( ) - 1,
+        static_cast< size_t >( percentile / 100.f * times.size( )));
+    std::nth_element( times.begin( ), times.begin( ) + n, times.end( ));
+    return times[ n ];
+}
+
+void FrameStats::open( const std::string& fileName, const uint32_t window )
+{
+    lunchbox::ScopedWrite _mutex( _fileLock );
+
+    if( _enabled )
+        return;
+
+    _window = window;
+
+    if( !fileName.empty( ))
+    {
+        // one file per process, <name>.<pid><ext>
+        std::string base = fileName;
+        std::string ext;
+        const size_t dot = fileName.rfind( '.' );
+        if( dot != std::string::npos &&
+            fileName.find( '/', dot ) == std::string::npos )
+        {
+            base = fileName.substr( 0, dot );
+            ext = fileName.substr( dot );
+        }
+        _json = ( ext == ".json" );
+
+        std::ostringstream name;
+        name << base << "." << getpid( ) << ext;
+
+        _file = new std::ofstream( name.str( ).c_str( ));
+        if( !*_file )
+        {
+            LBWARN << "Unable to write stats " << name.str( ) << std::endl;
+            delete _file;
+            _file = 0;
+        }
+        else if( !_json )
+        {
+            *_file << "name,frame";
+            for( uint32_t i = 0; i < STAGE_ALL; ++i )
+                *_file << "," << _stageNames[ i ];
+            for( uint32_t i = 0; i < COUNTER_ALL; ++i )
+                *_file << "," << _counterNames[ i ];
+            *_file << std::endl;
+        }
+    }
+
+    _enabled = ( _file || ( _window > 0 ));
+}
+
+void FrameStats::close( )
+{
+    lunchbox::ScopedWrite _mutex( _fileLock );
+
+    _enabled = false;
+
+    delete _file;
+    _file = 0;
+}
+}
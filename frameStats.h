@@ -0,0 +1,74 @@
+#pragma once
+
+#include <eq/eq.h>
+
+namespace eqEarth
+{
+/**
+ * Per frame time of each stage of one channel or node in ms, plus counters.
+ * Rows go to the process' --stats file, CSV or JSON lines by extension, and
+ * the last --stats-window frames are kept to log p50/p95/p99 every window.
+ */
+class FrameStats
+{
+public:
+    enum Stage
+    {
+        STAGE_EVENT = 0,
+        STAGE_UPDATE,
+        STAGE_PAGER_MERGE,
+        STAGE_CULL,
+        STAGE_DRAW,
+        STAGE_READBACK,
+        STAGE_COMPRESS, // of the output frames, see Channel
+        STAGE_DECOMPRESS,
+        STAGE_ASSEMBLE,
+        STAGE_SWAP,
+        STAGE_ALL
+    };
+
+    enum Counter
+    {
+        COUNTER_HORIZON_TILES = 0, // culled behind the horizon
+        COUNTER_HORIZON_NODES,
+        COUNTER_RANGE_NODES, // left to other sources of a DB compound
+        COUNTER_RAW_BYTES, // of the output frames
+        COUNTER_COMPRESSED_BYTES,
+        COUNTER_ALL
+    };
+
+    FrameStats( );
+
+    void setName( const std::string& name ) { _name = name; }
+    const std::string& getName( ) const { return _name; }
+
+    /** Add time to a stage of the current frame, thread safe. */
+    void add( const Stage stage, const float time );
+
+    /** Add to a counter of the current frame, thread safe. */
+    void count( const Counter counter, const uint32_t n );
+
+    /** Write the current frame and start the next one. */
+    void finish( const uint32_t frameNumber );
+
+    /** @return the given percentile of a stage over the window. */
+    float getPercentile( const Stage stage, const float percentile ) const;
+
+    /** Open the output of this process, does nothing if already open. */
+    static void open( const std::string& fileName, const uint32_t window );
+    static void close( );
+    static bool isEnabled( ) { return _enabled; }
+
+private:
+    std::string _name;
+
+    mutable lunchbox::Lock _lock;
+    float _times[ STAGE_ALL ];
+    std::vector< float > _history[ STAGE_ALL ]; // ring of the last window
+    uint32_t _counts[ COUNTER_ALL ];
+    uint64_t _windowCounts[ COUNTER_ALL ]; // sums over the current window
+    uint32_t _numFrames;
+
+    static bool _enabled;
+};
+}
@@ -0,0 +1,137 @@
+#include "horizonCullVisitor.h"
+
+#include <osg/Camera>
+#include <osg/Geode>
+#include <osg/LOD>
+#include <osg/Transform>
+
+#include <algorithm>
+
+// Terrain below the ellipsoid is hidden by less than the full ellipsoid
+#define HORIZON_MIN_ELEVATION -500.0
+
+namespace eqEarth
+{
+// ----------------------------------------------------------------------------
+
+HorizonCullVisitor::HorizonCullVisitor( )
+    : osgUtil::CullVisitor( )
+    , _radius( 0. )
+    , _enabled( false )
+    , _horizonPlane( 0. )
+    , _horizonAngle( 0. )
+    , _nestedCameras( 0 )
+    , _numCulledTiles( 0 )
+    , _numCulledNodes( 0 )
+{
+}
+
+HorizonCullVisitor::HorizonCullVisitor( const HorizonCullVisitor& rhs )
+    : osgUtil::CullVisitor( rhs )
+    , _radius( rhs._radius )
+    , _enabled( false )
+    , _horizonPlane( 0. )
+    , _horizonAngle( 0. )
+    , _nestedCameras( 0 )
+    , _numCulledTiles( 0 )
+    , _numCulledNodes( 0 )
+{
+}
+
+void HorizonCullVisitor::setViewMatrix( const osg::Matrixd& viewMatrix )
+{
+    const double radius = _radius + HORIZON_MIN_ELEVATION;
+    const osg::Vec3d center = viewMatrix.getTrans( );
+    const double d = center.length( );
+
+    _enabled = ( _radius > 0. ) && ( d > radius );
+    _nestedCameras = 0;
+    if( !_enabled )
+        return;
+
+    _direction = center / d;
+    _horizonPlane = ( d * d - radius * radius ) / d;
+    _horizonAngle = asin( radius / d );
+}
+
+void HorizonCullVisitor::apply( osg::Group& node )
+{
+    if( isBeyondHorizon( node ))
+        ++_numCulledNodes;
+    else
+        osgUtil::CullVisitor::apply( node );
+}
+
+void HorizonCullVisitor::apply( osg::Transform& node )
+{
+    if( isBeyondHorizon( node ))
+        ++_numCulledNodes;
+    else
+        osgUtil::CullVisitor::apply( node );
+}
+
+void HorizonCullVisitor::apply( osg::LOD& node )
+{
+    if( isBeyondHorizon( node ))
+        ++_numCulledTiles;
+    else
+        osgUtil::CullVisitor::apply( node );
+}
+
+void HorizonCullVisitor::apply( osg::Geode& node )
+{
+    if( isBeyondHorizon( node ))
+        ++_numCulledNodes;
+    else
+        osgUtil::CullVisitor::apply( node );
+}
+
+void HorizonCullVisitor::apply( osg::Camera& camera )
+{
+    // The model view below is relative to this camera, _direction and
+    // _horizonPlane are in the eye space of the main camera
+    ++_nestedCameras;
+    osgUtil::CullVisitor::apply( camera );
+    --_nestedCameras;
+}
+
+double HorizonCullVisitor::getScale( const osg::Matrixd& mv )
+{
+    return sqrt( std::max( std::max(
+        osg::Vec3d( mv( 0, 0 ), mv( 0, 1 ), mv( 0, 2 )).length2( ),
+        osg::Vec3d( mv( 1, 0 ), mv( 1, 1 ), mv( 1, 2 )).length2( )),
+        osg::Vec3d( mv( 2, 0 ), mv( 2, 1 ), mv( 2, 2 )).length2( )));
+}
+
+bool HorizonCullVisitor::isBeyondHorizon( osg::Node& node )
+{
+    if( !_enabled || isInNestedCamera( ) || !node.isCullingActive( ))
+        return false;
+
+    const osg::BoundingSphere& bs = node.getBound( );
+    if( !bs.valid( ))
+        return false;
+
+    // Only count what the frustum would keep, the base class culls the rest
+    if( isCulled( node ))
+        return false;
+
+    const osg::Matrixd& mv = *getModelViewMatrix( );
+    const osg::Vec3d center = bs.center( ) * mv;
+    const double radius = bs.radius( ) * getScale( mv );
+
+    // Entirely beyond the plane of the horizon circle ...
+    if( center * _direction - radius <= _horizonPlane )
+        return false;
+
+    // ... and inside the cone from the eye to the horizon, i.e. behind
+    // the globe as seen from the eye
+    const double distance = center.length( );
+    if( radius >= distance )
+        return false;
+
+    const double angle = acos( osg::clampBetween(
+        center * _direction / distance, -1., 1. ));
+    return angle + asin( radius / distance ) <= _horizonAngle;
+}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <osgUtil/CullVisitor>
+
+namespace eqEarth
+{
+/**
+ * Cull visitor that also rejects subgraphs entirely behind the horizon of
+ * the ellipsoid, e.g. terrain tiles and annotations on the far side of the
+ * globe that the frustum alone keeps at mid altitudes.
+ */
+class HorizonCullVisitor : public osgUtil::CullVisitor
+{
+public:
+    HorizonCullVisitor( );
+    HorizonCullVisitor( const HorizonCullVisitor& rhs );
+
+    META_NodeVisitor( eqEarth, HorizonCullVisitor )
+
+    virtual osgUtil::CullVisitor* clone( ) const
+        { return new HorizonCullVisitor( *this ); }
+
+    /** Polar radius of the globe, 0 disables the horizon test. */
+    void setRadius( const double radius ) { _radius = radius; }
+    double getRadius( ) const { return _radius; }
+
+    /** The view matrix of the next cull. */
+    virtual void setViewMatrix( const osg::Matrixd& viewMatrix );
+
+    virtual void apply( osg::Group& node );
+    virtual void apply( osg::Transform& node );
+    virtual void apply( osg::LOD& node );
+    virtual void apply( osg::Geode& node );
+
+    /** Nested cameras, e.g. render to texture, have their own eye space. */
+    virtual void apply( osg::Camera& camera );
+
+    /** @return the LODs, i.e. tiles, and other nodes rejected. */
+    uint32_t getNumCulledTiles( ) const { return _numCulledTiles; }
+    uint32_t getNumCulledNodes( ) const { return _numCulledNodes; }
+    virtual void resetCounters( ) { _numCulledTiles = _numCulledNodes = 0; }
+
+protected:
+    /** @return the largest scale of the axes of a model view matrix. */
+    static double getScale( const osg::Matrixd& mv );
+
+    /** @return whether the traversal is below a nested camera. */
+    bool isInNestedCamera( ) const { return _nestedCameras > 0; }
+
+private:
+    double _radius;
+    bool _enabled; // for this cull, i.e. the eye is above the globe
+    osg::Vec3d _direction; // to the center of the globe in eye coordinates
+    double _horizonPlane; // distance of the horizon plane along _direction
+    double _horizonAngle; // between _direction and the horizon
+    uint32_t _nestedCameras; // depth of the cameras being traversed
+
+    uint32_t _numCulledTiles;
+    uint32_t _numCulledNodes;
+
+    bool isBeyondHorizon( osg::Node& node );
+};
+}
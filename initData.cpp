@@ -1,13 +1,34 @@
 #include "initData.h"
 
+#include <algorithm>
+#include <cstdlib>
+
 namespace eqEarth
 {
 // ----------------------------------------------------------------------------
 
 InitData::InitData( )
     : _frameDataID( eq::UUID::ZERO )
-    , _modelFileName( DEFAULT_MODEL )
+    , _modelFileNames( 1, DEFAULT_MODEL )
+    , _sceneBudget( 0 )
     , _kmlFileName( "" )
+    , _serializeDraw( false )
+    , _pipelineCull( false )
+    , _threadModel( eq::DRAW_SYNC )
+    , _depthMode( DEPTH_LINEAR )
+    , _lodDensity( 0.f )
+    , _targetFPS( 0.f )
+    , _compression( COMPRESSION_AUTO )
+    , _linkBandwidth( 0.f )
+    , _dropAlpha( false )
+    , _compositeThreads( 0 )
+    , _traceFileName( "" )
+    , _statsFileName( "" )
+    , _statsWindow( 0 )
+    , _benchViewpoints( "" )
+    , _benchFrames( 300 )
+    , _cameraPathFileName( "" )
+    , _replayCameraPath( false )
 {
 }
 
@@ -21,9 +42,14 @@ void InitData::setFrameDataID( const eq::uint128_t& id )
     _frameDataID = id;
 }
 
-void InitData::setModelFileName( const std::string &fileName )
+void InitData::setModelFileNames( const Strings& fileNames )
 {
-    _modelFileName = fileName;
+    _modelFileNames = fileNames;
+}
+
+void InitData::setSceneBudget( uint32_t numPagedLODs )
+{
+    _sceneBudget = numPagedLODs;
 }
 
 void InitData::setKMLFileName( const std::string &fileName )
@@ -31,22 +57,133 @@ void InitData::setKMLFileName( const std::string &fileName )
     _kmlFileName = fileName;
 }
 
+void InitData::setSerializeDraw( bool serializeDraw )
+{
+    _serializeDraw = serializeDraw;
+}
+
+void InitData::setPipelineCull( bool pipelineCull )
+{
+    _pipelineCull = pipelineCull;
+}
+
+void InitData::setThreadModel( int32_t threadModel )
+{
+    _threadModel = threadModel;
+}
+
+void InitData::setDepthMode( int32_t depthMode )
+{
+    _depthMode = depthMode;
+}
+
+void InitData::setLODDensity( float pixelsPerDegree )
+{
+    _lodDensity = pixelsPerDegree;
+}
+
+void InitData::setTargetFPS( float fps )
+{
+    _targetFPS = fps;
+}
+
+void InitData::setCompression( int32_t compression )
+{
+    _compression = compression;
+}
+
+void InitData::setLinkBandwidth( float mbps )
+{
+    _linkBandwidth = mbps;
+}
+
+void InitData::setDropAlpha( bool dropAlpha )
+{
+    _dropAlpha = dropAlpha;
+}
+
+void InitData::setCompositeThreads( uint32_t numThreads )
+{
+    _compositeThreads = numThreads;
+}
+
+void InitData::setTraceFileName( const std::string &fileName )
+{
+    _traceFileName = fileName;
+}
+
+void InitData::setStatsFileName( const std::string &fileName )
+{
+    _statsFileName = fileName;
+}
+
+void InitData::setStatsWindow( uint32_t numFrames )
+{
+    _statsWindow = numFrames;
+}
+
+void InitData::setBenchViewpoints( const std::string& viewpoints )
+{
+    _benchViewpoints = viewpoints;
+}
+
+void InitData::setBenchFrames( uint32_t numFrames )
+{
+    _benchFrames = numFrames;
+}
+
+void InitData::setCameraPathFileName( const std::string& fileName,
+        bool replay )
+{
+    _cameraPathFileName = fileName;
+    _replayCameraPath = replay;
+}
+
 void InitData::getInstanceData( co::DataOStream& stream )
 {
-    stream << _frameDataID << _modelFileName << _kmlFileName;
+    stream << _frameDataID << uint32_t( _modelFileNames.size( ));
+    for( Strings::const_iterator i = _modelFileNames.begin( );
+            i != _modelFileNames.end( ); ++i )
+        stream << *i;
+    stream << _sceneBudget << _kmlFileName
+        << _serializeDraw << _pipelineCull << _threadModel << _depthMode
+        << _lodDensity << _targetFPS
+        << _compression << _linkBandwidth << _dropAlpha << _compositeThreads
+        << _traceFileName << _statsFileName << _statsWindow
+        << _benchViewpoints << _benchFrames
+        << _cameraPathFileName << _replayCameraPath;
 }
 
 void InitData::applyInstanceData( co::DataIStream& stream )
 {
-    stream >> _frameDataID >> _modelFileName >> _kmlFileName;
+    uint32_t numModels;
+    stream >> _frameDataID >> numModels;
+    _modelFileNames.resize( numModels );
+    for( Strings::iterator i = _modelFileNames.begin( );
+            i != _modelFileNames.end( ); ++i )
+        stream >> *i;
+    stream >> _sceneBudget >> _kmlFileName
+        >> _serializeDraw >> _pipelineCull >> _threadModel >> _depthMode
+        >> _lodDensity >> _targetFPS
+        >> _compression >> _linkBandwidth >> _dropAlpha >> _compositeThreads
+        >> _traceFileName >> _statsFileName >> _statsWindow
+        >> _benchViewpoints >> _benchFrames
+        >> _cameraPathFileName >> _replayCameraPath;
 }
 
 bool InitData::parseCommandLine( char **argv, int argc )
 {
-    std::string model = _parseCommandLineParam( argc, argv, "--model" );
-    if( !model.empty( ))
+    Strings models = _parseCommandLineParams( argc, argv, "--model" );
+    if( !models.empty( ))
     {
-        setModelFileName( model );
+        setModelFileNames( models );
+    }
+
+    std::string budget =
+        _parseCommandLineParam( argc, argv, "--scene-budget" );
+    if( !budget.empty( ))
+    {
+        setSceneBudget( atoi( budget.c_str( )));
     }
 
     std::string kml = _parseCommandLineParam( argc, argv, "--kml" );
@@ -55,6 +192,160 @@ bool InitData::parseCommandLine( char **argv, int argc )
         setKMLFileName( kml );
     }
 
+    if( _parseCommandLineFlag( argc, argv, "--serialize-draw" ))
+    {
+        setSerializeDraw( true );
+    }
+
+    if( _parseCommandLineFlag( argc, argv, "--pipeline-cull" ))
+    {
+        setPipelineCull( true );
+    }
+
+    std::string threadModel =
+        _parseCommandLineParam( argc, argv, "--thread-model" );
+    if( !threadModel.empty( ))
+    {
+        if( threadModel == "async" )
+            setThreadModel( eq::ASYNC );
+        else if( threadModel == "draw_sync" )
+            setThreadModel( eq::DRAW_SYNC );
+        else if( threadModel == "local_sync" )
+            setThreadModel( eq::LOCAL_SYNC );
+        else
+        {
+            LBERROR << "Unknown thread model " << threadModel << std::endl;
+            return false;
+        }
+    }
+
+    std::string depth = _parseCommandLineParam( argc, argv, "--depth" );
+    if( !depth.empty( ))
+    {
+        if( depth == "linear" )
+            setDepthMode( DEPTH_LINEAR );
+        else if( depth == "log" )
+            setDepthMode( DEPTH_LOG );
+        else
+        {
+            LBERROR << "Unknown depth mode " << depth << std::endl;
+            return false;
+        }
+    }
+
+    std::string lodDensity =
+        _parseCommandLineParam( argc, argv, "--lod-density" );
+    if( !lodDensity.empty( ))
+    {
+        setLODDensity( atof( lodDensity.c_str( )));
+    }
+
+    std::string targetFPS =
+        _parseCommandLineParam( argc, argv, "--target-fps" );
+    if( !targetFPS.empty( ))
+    {
+        setTargetFPS( atof( targetFPS.c_str( )));
+    }
+
+    std::string compression =
+        _parseCommandLineParam( argc, argv, "--compression" );
+    if( !compression.empty( ))
+    {
+        if( compression == "auto" )
+            setCompression( COMPRESSION_AUTO );
+        else if( compression == "none" )
+            setCompression( COMPRESSION_NONE );
+        else if( compression == "lossless" )
+            setCompression( COMPRESSION_LOSSLESS );
+        else if( compression == "lossy" )
+            setCompression( COMPRESSION_LOSSY );
+        else
+        {
+            LBERROR << "Unknown compression " << compression << std::endl;
+            return false;
+        }
+    }
+
+    std::string bandwidth =
+        _parseCommandLineParam( argc, argv, "--link-bandwidth" );
+    if( !bandwidth.empty( ))
+    {
+        setLinkBandwidth( atof( bandwidth.c_str( )));
+    }
+
+    if( _parseCommandLineFlag( argc, argv, "--drop-alpha" ))
+    {
+        setDropAlpha( true );
+    }
+
+    std::string compositeThreads =
+        _parseCommandLineParam( argc, argv, "--cpu-composite" );
+    if( !compositeThreads.empty( ))
+    {
+        // capped to the cores of each render node by its channels
+        char* end = 0;
+        const long numThreads = strtol( compositeThreads.c_str( ), &end, 10 );
+        if( *end != '\0' || numThreads < 1 )
+        {
+            LBERROR << "Invalid number of composite threads "
+                << compositeThreads << std::endl;
+            return false;
+        }
+        setCompositeThreads( uint32_t( std::min( numThreads, 1L << 16 )));
+    }
+
+    // written as <file>.<pid>.json by every process
+    std::string trace = _parseCommandLineParam( argc, argv, "--trace" );
+    if( !trace.empty( ))
+    {
+        setTraceFileName( trace );
+    }
+
+    // .csv or .json, written as <file>.<pid><ext> by every process
+    std::string stats = _parseCommandLineParam( argc, argv, "--stats" );
+    if( !stats.empty( ))
+    {
+        setStatsFileName( stats );
+    }
+
+    std::string window =
+        _parseCommandLineParam( argc, argv, "--stats-window" );
+    if( !window.empty( ))
+    {
+        setStatsWindow( atoi( window.c_str( )));
+    }
+
+    // indices into vps.h, e.g. "0-9,12"
+    std::string bench = _parseCommandLineParam( argc, argv, "--bench" );
+    if( !bench.empty( ))
+    {
+        setBenchViewpoints( bench );
+    }
+
+    // frames per leg between two viewpoints
+    std::string benchFrames =
+        _parseCommandLineParam( argc, argv, "--bench-frames" );
+    if( !benchFrames.empty( ))
+    {
+        setBenchFrames( atoi( benchFrames.c_str( )));
+    }
+
+    std::string record = _parseCommandLineParam( argc, argv, "--record" );
+    std::string replay = _parseCommandLineParam( argc, argv, "--replay" );
+    if( !record.empty( ) && !replay.empty( ))
+    {
+        LBERROR << "Cannot both record and replay a camera path" << std::endl;
+        return false;
+    }
+    else if( !record.empty( ))
+    {
+        setCameraPathFileName( record, false );
+    }
+    else if( !replay.empty( ))
+    {
+        setCameraPathFileName( replay, true );
+    }
+
     return true;
 }
 
@@ -73,4 +364,34 @@ std::string InitData::_parseCommandLineParam( int argc, char** argv,
 
     return "";
 }
+
+bool InitData::_parseCommandLineFlag( int argc, char** argv,
+        std::string param )
+{
+    for ( int i = 1; i < argc; i++ )
+    {
+        if( strcmp( argv[i], param.c_str( )) == 0 )
+            return true;
+    }
+
+    return false;
+}
+
+InitData::Strings InitData::_parseCommandLineParams( int argc, char** argv,
+        std::string param )
+{
+    Strings values;
+
+    for ( int i = 1; i < argc; i++ )
+    {
+        if( strcmp( argv[i], param.c_str( )) == 0 )
+        {
+            ++i;
+            if( i < argc )
+                values.push_back( argv[i] );
+        }
+    }
+
+    return values;
+}
 }
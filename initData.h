@@ -15,12 +15,88 @@ public:
     void setFrameDataID( const eq::uint128_t& id );
     const eq::uint128_t& getFrameDataID( ) const { return _frameDataID; }
 
-    void setModelFileName( const std::string& filename );
-    std::string getModelFileName( ) const { return _modelFileName; }
+    typedef std::vector< std::string > Strings;
+
+    // scene N (1-based) shows model file N - 1
+    void setModelFileNames( const Strings& filenames );
+    const Strings& getModelFileNames( ) const { return _modelFileNames; }
+
+    void setSceneBudget( uint32_t numPagedLODs );
+    uint32_t getSceneBudget( ) const { return _sceneBudget; }
 
     void setKMLFileName( const std::string& filename );
     std::string getKMLFileName( ) const { return _kmlFileName; }
 
+    void setSerializeDraw( bool serializeDraw );
+    bool getSerializeDraw( ) const { return _serializeDraw; }
+
+    void setPipelineCull( bool pipelineCull );
+    bool getPipelineCull( ) const { return _pipelineCull; }
+
+    void setThreadModel( int32_t threadModel );
+    int32_t getThreadModel( ) const { return _threadModel; }
+
+    enum DepthMode
+    {
+        DEPTH_LINEAR,
+        DEPTH_LOG // logarithmic depth, near plane close to the camera
+    };
+
+    void setDepthMode( int32_t depthMode );
+    int32_t getDepthMode( ) const { return _depthMode; }
+
+    // pixels per degree at LOD scale 1, less dense channels page less
+    void setLODDensity( float pixelsPerDegree );
+    float getLODDensity( ) const { return _lodDensity; }
+
+    // draw at lower resolution while the draw time exceeds 1 / fps
+    void setTargetFPS( float fps );
+    float getTargetFPS( ) const { return _targetFPS; }
+
+    enum Compression
+    {
+        COMPRESSION_AUTO, // by link bandwidth, else Equalizer's choice
+        COMPRESSION_NONE,
+        COMPRESSION_LOSSLESS,
+        COMPRESSION_LOSSY // color only, depth stays lossless
+    };
+
+    // of the output frames of all channels
+    void setCompression( int32_t compression );
+    int32_t getCompression( ) const { return _compression; }
+
+    // MB/s between the nodes, 0 if unknown
+    void setLinkBandwidth( float mbps );
+    float getLinkBandwidth( ) const { return _linkBandwidth; }
+
+    // alpha is not used by the destination, don't send it
+    void setDropAlpha( bool dropAlpha );
+    bool getDropAlpha( ) const { return _dropAlpha; }
+
+    // composite DB input frames on the CPU with this many threads, 0 on the
+    // GPU
+    void setCompositeThreads( uint32_t numThreads );
+    uint32_t getCompositeThreads( ) const { return _compositeThreads; }
+
+    void setTraceFileName( const std::string& filename );
+    std::string getTraceFileName( ) const { return _traceFileName; }
+
+    void setStatsFileName( const std::string& filename );
+    std::string getStatsFileName( ) const { return _statsFileName; }
+
+    void setStatsWindow( uint32_t numFrames );
+    uint32_t getStatsWindow( ) const { return _statsWindow; }
+
+    void setBenchViewpoints( const std::string& viewpoints );
+    std::string getBenchViewpoints( ) const { return _benchViewpoints; }
+
+    void setBenchFrames( uint32_t numFrames );
+    uint32_t getBenchFrames( ) const { return _benchFrames; }
+
+    void setCameraPathFileName( const std::string& filename, bool replay );
+    std::string getCameraPathFileName( ) const { return _cameraPathFileName; }
+    bool getReplayCameraPath( ) const { return _replayCameraPath; }
+
 protected:
     virtual void getInstanceData( co::DataOStream& stream );
     virtual void applyInstanceData( co::DataIStream& stream );
@@ -31,9 +107,30 @@ public:
 private:
     std::string _parseCommandLineParam( int argc, char** argv,
         std::string param );
+    bool _parseCommandLineFlag( int argc, char** argv, std::string param );
+    Strings _parseCommandLineParams( int argc, char** argv,
+        std::string param );
 
     eq::uint128_t _frameDataID;
-    std::string _modelFileName;
+    Strings _modelFileNames;
+    uint32_t _sceneBudget;
     std::string _kmlFileName;
+    bool _serializeDraw;
+    bool _pipelineCull;
+    int32_t _threadModel;
+    int32_t _depthMode;
+    float _lodDensity;
+    float _targetFPS;
+    int32_t _compression;
+    float _linkBandwidth;
+    bool _dropAlpha;
+    uint32_t _compositeThreads;
+    std::string _traceFileName;
+    std::string _statsFileName;
+    uint32_t _statsWindow;
+    std::string _benchViewpoints;
+    uint32_t _benchFrames;
+    std::string _cameraPathFileName;
+    bool _replayCameraPath;
 };
 }
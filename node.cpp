@@ -4,8 +4,12 @@
 #include "error.h"
 #include "util.h"
 #include "pipe.h"
+#include "trace.h"
+#include "view.h"
 
 #include <osg/DeleteHandler>
+#include <osg/BufferObject>
+#include <osg/Texture>
 
 #include <osgEarth/MapNode>
 #include <osgEarth/NodeUtils>
@@ -16,9 +20,81 @@ namespace eqEarth
 {
 // ----------------------------------------------------------------------------
 
+struct PrefetchVisitor : public eq::ConfigVisitor
+{
+PrefetchVisitor( const FrameData& frameData, CompositeViewer* viewer,
+        Prefetcher& prefetcher )
+    : _frameData( frameData )
+    , _viewer( viewer )
+    , _prefetcher( prefetcher )
+{
+}
+
+virtual eq::VisitorResult visit( eq::View* view )
+{
+    const View* v = static_cast< const View* >( view );
+    if( v->getSlot( ) >= _frameData.getNumViewStates( ))
+        return eq::TRAVERSE_CONTINUE;
+
+    const ViewState& state = _frameData.getViewState( v->getSlot( ));
+    if( !state.prefetch )
+        return eq::TRAVERSE_CONTINUE;
+
+    // only the scenes drawn on this node
+    osgViewer::View* osgView = _viewer->findOSGViewByID( v->getSceneID( ));
+    if( osgView )
+        _prefetcher.prefetch( osgView,
+            vmmlToOsg( state.prefetchPose.getViewMatrix( )),
+            _viewer->getViewerFrameStamp( ));
+
+    return eq::TRAVERSE_CONTINUE;
+}
+
+const FrameData& _frameData;
+CompositeViewer* const _viewer;
+Prefetcher& _prefetcher;
+};
+
+// ----------------------------------------------------------------------------
+
+// Counts the draws on one context that may still read dynamic objects, which
+// the next update traversal modifies. Same as osgViewer's
+// EndOfDynamicDrawBlock, for draws that start and end in any frame.
+struct DynamicDrawCallback :
+    public osg::State::DynamicObjectRenderingCompletedCallback
+{
+DynamicDrawCallback( lunchbox::Monitor< uint32_t >& draws )
+    : _draws( draws )
+    , _drawing( false )
+{
+}
+
+void begin( )
+{
+    _drawing = true;
+    ++_draws;
+}
+
+// by the draw once the last dynamic object is drawn, or by drawLocked
+virtual void completed( osg::State* )
+{
+    if( !_drawing )
+        return;
+
+    _drawing = false;
+    --_draws;
+}
+
+lunchbox::Monitor< uint32_t >& _draws;
+bool _drawing; // only touched by the thread drawing this context
+};
+
+// ----------------------------------------------------------------------------
+
 Node::Node( eq::Config* parent )
     : eq::Node( parent )
     , _frameNumber( 0UL )
+    , _dynamicDraws( 0U )
 {
 LBINFO << "=====> Node::Node(" << (void *)this << ")" << std::endl;
 }
@@ -36,13 +112,24 @@ void Node::addGraphicsContext( osg::GraphicsContext* context )
     osg::ref_ptr< osgUtil::IncrementalCompileOperation > ico =
         config->getIncrementalCompileOperation( );
 
-    if( ico.valid( ))
-    {
-        const bool needViewerLock = ( getPipes( ).size( ) > 1 );
-        lunchbox::ScopedWrite _mutex( needViewerLock ? &_viewer_lock : 0 );
+    const bool needViewerLock = ( getPipes( ).size( ) > 1 );
+    lunchbox::ScopedWrite _mutex( needViewerLock ? &_viewer_lock : 0 );
+
+    // Pipes draw concurrently, create the per-context GL object managers
+    // up front so their lazily resized buffered_objects never grow while
+    // another pipe is drawing.
+    const unsigned int contextID = context->getState( )->getContextID( );
+    osg::Texture::getTextureObjectManager( contextID );
+    osg::GLBufferObjectManager::getGLBufferObjectManager( contextID );
+
+    // The next frame's update waits for the dynamic objects of draws still
+    // in flight
+    if( config->getInitData( ).getThreadModel( ) != eq::DRAW_SYNC )
+        context->getState( )->setDynamicObjectRenderingCompletedCallback(
+            new DynamicDrawCallback( _dynamicDraws ));
 
+    if( ico.valid( ))
         ico->addGraphicsContext( context );
-    }
 }
 
 void Node::removeGraphicsContext( osg::GraphicsContext* context )
@@ -94,18 +181,21 @@ void Node::addCameraToOSGView( const eq::uint128_t& id, osg::Camera* camera )
     {
         osgView = config->takeOrCreateOSGView( id );
 
-        _viewer->addView( osgView );
+        _viewer->addOSGView( osgView );
     }
 
     LBCHECK( osgView->addSlave( camera ));
 
-    osg::ref_ptr< osgEarth::MapNode > mapNode =
-        osgEarth::MapNode::findMapNode( osgView->getSceneData( ));
+    const SceneDescriptor& scene =
+        CompositeViewer::getSceneDescriptor( osgView );
+
+    static_cast< Renderer* >( camera->getRenderer( ))->setHorizonRadius(
+        scene.geocentric ? scene.radiusPolar : 0. );
 #if 0
-    if( mapNode.valid( ) && mapNode->isGeocentric( ))
+    if( scene.geocentric )
     {
         camera->addCullCallback(
-            new osgEarth::Util::AutoClipPlaneCullCallback( mapNode ));
+            new osgEarth::Util::AutoClipPlaneCullCallback( scene.mapNode ));
         camera->setComputeNearFarMode(
             osg::CullSettings::COMPUTE_NEAR_FAR_USING_PRIMITIVES );
         camera->setNearFarRatio( 0.00002 );
@@ -115,7 +205,10 @@ void Node::addCameraToOSGView( const eq::uint128_t& id, osg::Camera* camera )
 #endif
 
     if( needFrameStart )
+    {
+        OpenThreads::ScopedWriteLock _lock( _scene_lock );
         _viewer->frameStart( _frameNumber, getFrameData( ));
+    }
 
 //LBINFO << "<----- Node::addCameraToView(" << id << ")" << std::endl;
 }
@@ -137,7 +230,7 @@ void Node::removeCameraFromOSGView( const eq::uint128_t& id,
 
     if( osgView->getNumSlaves( ) == 0 )
     {
-        _viewer->removeView( osgView );
+        _viewer->removeOSGView( osgView );
 
         static_cast< Config* >( getConfig( ))->releaseOSGView( osgView );
     }
@@ -163,8 +256,23 @@ LBINFO << "-----> Node::configInit(" << initID << ")" << std::endl;
     if( !eq::Node::configInit( initID ))
         goto out;
 
-    // OSG is *not* multi-buffered
-    setIAttribute( IATTR_THREAD_MODEL, eq::DRAW_SYNC );
+    // OSG is *not* multi-buffered: DRAW_SYNC unless asked otherwise. The
+    // pipes have their own FrameData and Views, culls are kept out of the
+    // update traversal by _scene_lock and the update waits for the dynamic
+    // objects of draws in flight, so the next frame's update may overlap
+    // the rest of this frame's draw, readback, assembly and swap.
+    setIAttribute( IATTR_THREAD_MODEL, initData.getThreadModel( ));
+
+    if( initData.getThreadModel( ) != eq::DRAW_SYNC )
+    {
+        // Objects released by the update traversal may still be referenced
+        // by render bins being drawn, same as osgViewer's threaded models.
+        if( !osg::Referenced::getDeleteHandler( ))
+            osg::Referenced::setDeleteHandler( new osg::DeleteHandler( 2 ));
+        else
+            osg::Referenced::getDeleteHandler( )->
+                setNumFramesToRetainObjects( 2 );
+    }
 
     if( !config->mapInitData( initID ))
     {
@@ -178,6 +286,15 @@ LBINFO << "-----> Node::configInit(" << initID << ")" << std::endl;
         goto out;
     }
 
+    if( !initData.getTraceFileName( ).empty( ))
+        Trace::enable( initData.getTraceFileName( ), config->getTime( ));
+
+    if( !initData.getStatsFileName( ).empty( ) ||
+            initData.getStatsWindow( ) > 0 )
+        FrameStats::open( initData.getStatsFileName( ),
+            initData.getStatsWindow( ));
+    _stats.setName( "node " + getName( ));
+
     init = true;
 
 out:
@@ -191,6 +308,9 @@ LBINFO << "<----- Node::configInit(" << initID << ")" << std::endl;
 
 bool Node::configExit( )
 {
+    Trace::write( );
+    FrameStats::close( );
+
     cleanup( );
 
     return eq::Node::configExit( );
@@ -199,8 +319,7 @@ bool Node::configExit( )
 void Node::frameStart( const eq::uint128_t& frameID,
         const uint32_t frameNumber )
 {
-LBINFO << "-----> Node<" << getName( ) << ">::frameStart("
-    << frameID << ", " << frameNumber << ")" << std::endl;
+    EQEARTH_TRACE_SCOPE( "Node::frameStart", frameNumber );
 
     _frameData.sync( frameID );
     _frameNumber = frameNumber;
@@ -209,33 +328,38 @@ LBINFO << "-----> Node<" << getName( ) << ">::frameStart("
     {
         LBASSERT( _viewer->getNumViews( ) > 0 );
 
-        _viewer->frameStart( frameNumber, _frameData );
+        OpenThreads::ScopedWriteLock _lock( _scene_lock );
+
+        // With ASYNC and LOCAL_SYNC pipes may still draw the last frame.
+        // New draws wait for the lock, so this only waits for those in
+        // flight to draw their dynamic objects.
+        _dynamicDraws.waitEQ( 0U );
+
+        _viewer->frameStart( frameNumber, _frameData, &_stats );
+
+        // Load ahead where moving cameras are heading
+        PrefetchVisitor prefetch( _frameData, _viewer.get( ), _prefetcher );
+        getConfig( )->accept( prefetch );
     }
 
     // aka "dispatch the rendering threads" - unlocks Channel::frameDraw!
     eq::Node::frameStart( frameID, frameNumber );
-
-LBINFO << "<----- Node<" << getName( ) << ">::frameStart("
-    << frameID << ", " << frameNumber << ")" << std::endl;
 }
 
 void Node::frameFinish( const eq::uint128_t& frameID,
         const uint32_t frameNumber )
 {
-LBINFO << "-----> Node<" << getName( ) << ">::frameFinish("
-    << frameID << ", " << frameNumber << ")" << std::endl;
+    EQEARTH_TRACE_SCOPE( "Node::frameFinish", frameNumber );
 
-    eq::Node::frameFinish( frameID, frameNumber );
+    _stats.finish( frameNumber );
 
-LBINFO << "<----- Node<" << getName( ) << ">::frameFinish("
-    << frameID << ", " << frameNumber << ")" << std::endl;
+    eq::Node::frameFinish( frameID, frameNumber );
 }
 
 void Node::frameDrawFinish( const eq::uint128_t& frameID,
         const uint32_t frameNumber )
 {
-LBINFO << "-----> Node<" << getName( ) << ">::frameDrawFinish("
-    << frameID << ", " << frameNumber << ")" << std::endl;
+    EQEARTH_TRACE_SCOPE( "Node::frameDrawFinish", frameNumber );
 
     if( _viewer.valid( ))
     {
@@ -245,9 +369,6 @@ LBINFO << "-----> Node<" << getName( ) << ">::frameDrawFinish("
     }
 
     eq::Node::frameDrawFinish( frameID, frameNumber );
-
-LBINFO << "<----- Node<" << getName( ) << ">::frameDrawFinish("
-    << frameID << ", " << frameNumber << ")" << std::endl;
 }
 
 void Node::cleanup( )
@@ -265,13 +386,52 @@ void Node::renderLocked( osgViewer::Renderer* renderer ) const
 
     LBASSERT( renderer );
 
+    cullLocked( renderer );
+    drawLocked( renderer );
+}
+
+void Node::cullLocked( osgViewer::Renderer* renderer ) const
+{
+    LB_TS_NOT_THREAD( _nodeThread );
+
+    LBASSERT( renderer );
+
+    EQEARTH_TRACE_SCOPE( "Node::cull", _frameNumber );
+
+    OpenThreads::ScopedReadLock _lock( _scene_lock );
     renderer->cull( );
+}
 
-    {
-        const bool needViewerLock = ( getPipes( ).size( ) > 1 );
-        lunchbox::ScopedWrite _mutex( needViewerLock ? &_viewer_lock : 0 );
+void Node::drawLocked( osgViewer::Renderer* renderer ) const
+{
+    LB_TS_NOT_THREAD( _nodeThread );
+
+    LBASSERT( renderer );
 
-        renderer->draw( );
+    EQEARTH_TRACE_SCOPE( "Node::draw", _frameNumber );
+
+    // All GL state touched by SceneView::draw is per context, so pipes
+    // only need to be serialized when explicitly asked for.
+    const InitData& initData =
+        static_cast< const Config* >( getConfig( ))->getInitData( );
+    const bool needViewerLock = initData.getSerializeDraw( ) &&
+        ( getPipes( ).size( ) > 1 );
+    lunchbox::ScopedWrite _mutex( needViewerLock ? &_viewer_lock : 0 );
+
+    DynamicDrawCallback* dynamicDraw =
+        dynamic_cast< DynamicDrawCallback* >( renderer->getCamera( )->
+            getGraphicsContext( )->getState( )->
+                getDynamicObjectRenderingCompletedCallback( ));
+    if( dynamicDraw )
+    {
+        OpenThreads::ScopedReadLock _lock( _scene_lock );
+        dynamicDraw->begin( );
     }
+
+    renderer->draw( );
+
+    // in case the draw returned before drawing all dynamic objects
+    if( dynamicDraw )
+        dynamicDraw->completed( 0 );
 }
 }
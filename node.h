@@ -3,12 +3,18 @@
 #include <eq/eq.h>
 
 #include "frameData.h"
+#include "frameStats.h"
+#include "prefetcher.h"
 #include "viewer.h"
 #include "channel.h"
 
 #include <osgGA/GUIEventHandler>
 #include <osgViewer/Renderer>
 
+#include <lunchbox/monitor.h>
+
+#include <OpenThreads/ReadWriteMutex>
+
 namespace eqEarth
 {
 class Node : public eq::Node
@@ -22,6 +28,8 @@ protected:
 public:
     const FrameData& getFrameData( ) const { return _frameData; }
 
+    FrameStats& getStats( ) { return _stats; }
+
     void addGraphicsContext( osg::GraphicsContext* context );
     void removeGraphicsContext( osg::GraphicsContext* context );
 
@@ -51,11 +59,21 @@ private:
 protected:
     FrameData _frameData;
     uint32_t _frameNumber;
+    FrameStats _stats;
 
     mutable lunchbox::Lock _viewer_lock;
     osg::ref_ptr< CompositeViewer > _viewer;
+    Prefetcher _prefetcher; // node thread, with _scene_lock
+
+    // Culls read the scene graph the viewer's update traversal modifies
+    mutable OpenThreads::ReadWriteMutex _scene_lock;
+
+    // Draws that may still read dynamic objects, see DynamicDrawCallback
+    mutable lunchbox::Monitor< uint32_t > _dynamicDraws;
 
 public:
     void renderLocked( osgViewer::Renderer* renderer ) const;
+    void cullLocked( osgViewer::Renderer* renderer ) const;
+    void drawLocked( osgViewer::Renderer* renderer ) const;
 };
 }
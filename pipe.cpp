@@ -1,6 +1,7 @@
 #include "pipe.h"
 
 #include "config.h"
+#include "node.h"
 
 namespace eqEarth
 {
@@ -8,6 +9,7 @@ namespace eqEarth
 
 Pipe::Pipe( eq::Node* parent )
     : eq::Pipe( parent )
+    , _cullThread( 0 )
 {
 LBINFO << "=====> Pipe::Pipe(" << (void *)this << ")" << std::endl;
 }
@@ -27,7 +29,23 @@ LBINFO << "-----> Pipe::configInit(" << initID << ")" << std::endl;
         goto out;
 
     {
-        static_cast< Config* >( getConfig( ))->setThreadHint( isThreaded( ));
+        Config* config = static_cast< Config* >( getConfig( ));
+        config->setThreadHint( isThreaded( ));
+
+        if( !config->mapObject( &_frameData,
+                config->getInitData( ).getFrameDataID( )))
+        {
+            //setError( ERROR_EQEARTH_MAPOBJECT_FAILED );
+            goto out;
+        }
+
+        if( config->getInitData( ).getPipelineCull( ))
+        {
+            _cullThread =
+                new CullThread( static_cast< const Node* >( getNode( )));
+            if( !_cullThread->start( ))
+                goto out;
+        }
     }
 
     init = true;
@@ -54,6 +72,8 @@ void Pipe::frameStart( const eq::uint128_t& frameID,
 //LBINFO << "-----> Pipe<" << getName( ) << ">::frameStart("
 //    << frameID << ", " << frameNumber << ")" << std::endl;
 
+    _frameData.sync( frameID );
+
     eq::Pipe::frameStart( frameID, frameNumber );
 
 //LBINFO << "<----- Pipe<" << getName( ) << ">::frameStart("
@@ -78,6 +98,10 @@ void Pipe::frameDrawFinish( const eq::uint128_t& frameID,
 //LBINFO << "-----> Pipe<" << getName( ) << ">::frameDrawFinish("
 //    << frameID << ", " << frameNumber << ")" << std::endl;
 
+    // Culls must not overlap the next frame's update traversal
+    if( _cullThread )
+        _cullThread->waitIdle( );
+
     eq::Pipe::frameDrawFinish( frameID, frameNumber );
 
 //LBINFO << "<----- Pipe<" << getName( ) << ">::frameDrawFinish("
@@ -86,5 +110,13 @@ void Pipe::frameDrawFinish( const eq::uint128_t& frameID,
 
 void Pipe::cleanup( )
 {
+    if( _frameData.isAttached( ))
+        getConfig( )->unmapObject( &_frameData );
+
+    if( _cullThread )
+        _cullThread->stop( );
+
+    delete _cullThread;
+    _cullThread = 0;
 }
 }
@@ -2,6 +2,9 @@
 
 #include <eq/eq.h>
 
+#include "cullThread.h"
+#include "frameData.h"
+
 namespace eqEarth
 {
 class Pipe : public eq::Pipe
@@ -12,6 +15,12 @@ public:
 protected:
     virtual ~Pipe( );
 
+public:
+    const FrameData& getFrameData( ) const { return _frameData; }
+
+    /** @return the cull thread if cull/draw is pipelined, 0 otherwise. */
+    CullThread* getCullThread( ) { return _cullThread; }
+
 protected:
     virtual bool configInit( const eq::uint128_t& initID );
     virtual bool configExit( );
@@ -25,5 +34,11 @@ protected:
 
 private:
     void cleanup( );
+
+    // Per pipe copy, the node's instance may already be synced to a later
+    // frame when the node does not run in DRAW_SYNC
+    FrameData _frameData;
+
+    CullThread* _cullThread;
 };
 }
@@ -0,0 +1,113 @@
+#include "pose.h"
+
+namespace eqEarth
+{
+// ----------------------------------------------------------------------------
+
+Pose::Pose( )
+    : position( eq::Vector3f::ZERO )
+{
+    orientation[0] = orientation[1] = orientation[2] = 0.f;
+    orientation[3] = 1.f;
+}
+
+Pose::Pose( const eq::Matrix4f& m )
+{
+    // eye = -R^T * t
+    for( size_t i = 0; i < 3; ++i )
+        position[i] = -( double( m( 0, i )) * m( 0, 3 ) +
+            double( m( 1, i )) * m( 1, 3 ) + double( m( 2, i )) * m( 2, 3 ));
+
+    double q[4]; // x, y, z, w
+    const double trace = double( m( 0, 0 )) + m( 1, 1 ) + m( 2, 2 );
+    if( trace > 0. )
+    {
+        const double s = sqrt( trace + 1. ) * 2.;
+        q[3] = 0.25 * s;
+        q[0] = ( m( 2, 1 ) - m( 1, 2 )) / s;
+        q[1] = ( m( 0, 2 ) - m( 2, 0 )) / s;
+        q[2] = ( m( 1, 0 ) - m( 0, 1 )) / s;
+    }
+    else if( m( 0, 0 ) > m( 1, 1 ) && m( 0, 0 ) > m( 2, 2 ))
+    {
+        const double s = sqrt( 1. + m( 0, 0 ) - m( 1, 1 ) - m( 2, 2 )) * 2.;
+        q[3] = ( m( 2, 1 ) - m( 1, 2 )) / s;
+        q[0] = 0.25 * s;
+        q[1] = ( m( 0, 1 ) + m( 1, 0 )) / s;
+        q[2] = ( m( 0, 2 ) + m( 2, 0 )) / s;
+    }
+    else if( m( 1, 1 ) > m( 2, 2 ))
+    {
+        const double s = sqrt( 1. + m( 1, 1 ) - m( 0, 0 ) - m( 2, 2 )) * 2.;
+        q[3] = ( m( 0, 2 ) - m( 2, 0 )) / s;
+        q[0] = ( m( 0, 1 ) + m( 1, 0 )) / s;
+        q[1] = 0.25 * s;
+        q[2] = ( m( 1, 2 ) + m( 2, 1 )) / s;
+    }
+    else
+    {
+        const double s = sqrt( 1. + m( 2, 2 ) - m( 0, 0 ) - m( 1, 1 )) * 2.;
+        q[3] = ( m( 1, 0 ) - m( 0, 1 )) / s;
+        q[0] = ( m( 0, 2 ) + m( 2, 0 )) / s;
+        q[1] = ( m( 1, 2 ) + m( 2, 1 )) / s;
+        q[2] = 0.25 * s;
+    }
+
+    // q and -q are the same rotation, keep one so that equal views compare
+    const double length = sqrt( q[0] * q[0] + q[1] * q[1] + q[2] * q[2] +
+        q[3] * q[3] );
+    const double scale = (( q[3] < 0. ) ? -1. : 1. ) / length;
+    for( size_t i = 0; i < 4; ++i )
+        orientation[i] = static_cast< float >( q[i] * scale );
+}
+
+eq::Matrix4f Pose::getViewMatrix( ) const
+{
+    double q[4];
+    double length = 0.;
+    for( size_t i = 0; i < 4; ++i )
+    {
+        q[i] = orientation[i];
+        length += q[i] * q[i];
+    }
+    length = sqrt( length );
+    for( size_t i = 0; i < 4; ++i )
+        q[i] /= length;
+
+    const double& x = q[0];
+    const double& y = q[1];
+    const double& z = q[2];
+    const double& w = q[3];
+
+    double r[3][3];
+    r[0][0] = 1. - 2. * ( y * y + z * z );
+    r[0][1] = 2. * ( x * y - z * w );
+    r[0][2] = 2. * ( x * z + y * w );
+    r[1][0] = 2. * ( x * y + z * w );
+    r[1][1] = 1. - 2. * ( x * x + z * z );
+    r[1][2] = 2. * ( y * z - x * w );
+    r[2][0] = 2. * ( x * z - y * w );
+    r[2][1] = 2. * ( y * z + x * w );
+    r[2][2] = 1. - 2. * ( x * x + y * y );
+
+    eq::Matrix4f m( eq::Matrix4f::IDENTITY );
+    for( size_t i = 0; i < 3; ++i )
+    {
+        for( size_t j = 0; j < 3; ++j )
+            m( i, j ) = r[i][j];
+
+        // t = -R * eye
+        m( i, 3 ) = -( r[i][0] * position[0] + r[i][1] * position[1] +
+            r[i][2] * position[2] );
+    }
+    return m;
+}
+
+bool Pose::hasOrientation( const Pose& rhs ) const
+{
+    return orientation[0] == rhs.orientation[0] &&
+        orientation[1] == rhs.orientation[1] &&
+        orientation[2] == rhs.orientation[2] &&
+        orientation[3] == rhs.orientation[3];
+}
+}
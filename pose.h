@@ -0,0 +1,24 @@
+#pragma once
+
+#include <eq/eq.h>
+
+namespace eqEarth
+{
+/**
+ * Compact form of a rigid view matrix: the eye in world coordinates and the
+ * rotation as a unit quaternion, 28 instead of 64 bytes, as exact as the
+ * float matrix.
+ */
+struct Pose
+{
+    Pose( );
+    explicit Pose( const eq::Matrix4f& viewMatrix );
+
+    eq::Matrix4f getViewMatrix( ) const;
+
+    bool hasOrientation( const Pose& rhs ) const;
+
+    eq::Vector3f position;
+    float orientation[4]; // x, y, z, w with w >= 0
+};
+}
@@ -0,0 +1,101 @@
+#include "prefetcher.h"
+
+#include "viewer.h"
+
+// A typical channel, the frustum only decides which tiles are requested
+#define PREFETCH_FOVY 60.0
+#define PREFETCH_WIDTH 1920
+#define PREFETCH_HEIGHT 1080
+#define PREFETCH_NEAR_RATIO 0.00001
+
+// Below any request of a cull for drawing in the same frame
+#define PREFETCH_PRIORITY_OFFSET -1000.f
+
+namespace eqEarth
+{
+// ----------------------------------------------------------------------------
+
+void Prefetcher::RequestHandler::requestNodeFile( const std::string& fileName,
+        osg::NodePath& nodePath, float priority,
+        const osg::FrameStamp* frameStamp,
+        osg::ref_ptr< osg::Referenced >& databaseRequest,
+        const osg::Referenced* options )
+{
+    _pager->requestNodeFile( fileName, nodePath,
+        priority + PREFETCH_PRIORITY_OFFSET, frameStamp, databaseRequest,
+        options );
+}
+
+Prefetcher::Prefetcher( )
+    : _cullVisitor( new HorizonCullVisitor )
+    , _stateGraph( new osgUtil::StateGraph )
+    , _renderStage( new osgUtil::RenderStage )
+    , _viewport( new osg::Viewport( 0, 0, PREFETCH_WIDTH, PREFETCH_HEIGHT ))
+    , _requestHandler( new RequestHandler )
+{
+}
+
+Prefetcher::~Prefetcher( )
+{
+}
+
+void Prefetcher::prefetch( osgViewer::View* osgView,
+        const osg::Matrixd& viewMatrix, const osg::FrameStamp* frameStamp )
+{
+    osgDB::DatabasePager* pager = osgView->getDatabasePager( );
+    osg::Camera* camera = osgView->getCamera( );
+    if( !pager || !camera || camera->getNumChildren( ) == 0 )
+        return;
+
+    const SceneDescriptor& scene =
+        CompositeViewer::getSceneDescriptor( osgView );
+
+    // Out to the far side of the scene, the horizon test drops the far side
+    // of a globe
+    const osg::BoundingSphere& bs = camera->getBound( );
+    const osg::Vec3d eye = osg::Matrixd::inverse( viewMatrix ).getTrans( );
+    const double far = ( eye - bs.center( )).length( ) + bs.radius( );
+    const double near = osg::clampAbove( far * PREFETCH_NEAR_RATIO, 1. );
+
+    osg::ref_ptr< osg::RefMatrix > projection = new osg::RefMatrix(
+        osg::Matrixd::perspective( PREFETCH_FOVY,
+            double( PREFETCH_WIDTH ) / PREFETCH_HEIGHT, near, far ));
+    osg::ref_ptr< osg::RefMatrix > modelView =
+        new osg::RefMatrix( viewMatrix );
+
+    _stateGraph->clean( );
+    _renderStage->reset( );
+    _renderStage->setCamera( camera );
+    _renderStage->setViewport( _viewport.get( ));
+    _requestHandler->setPager( pager );
+
+    HorizonCullVisitor& cv = *_cullVisitor;
+    cv.reset( );
+    cv.setCullSettings( *camera );
+    cv.setComputeNearFarMode( osg::CullSettings::DO_NOT_COMPUTE_NEAR_FAR );
+    cv.setRadius( scene.geocentric ? scene.radiusPolar : 0. );
+    cv.setViewMatrix( viewMatrix );
+    cv.setFrameStamp( const_cast< osg::FrameStamp* >( frameStamp ));
+    cv.setTraversalNumber( frameStamp->getFrameNumber( ));
+    cv.setDatabaseRequestHandler( _requestHandler.get( ));
+    cv.setStateGraph( _stateGraph.get( ));
+    cv.setRenderStage( _renderStage.get( ));
+
+    cv.pushViewport( _viewport.get( ));
+    cv.pushProjectionMatrix( projection.get( ));
+    cv.pushModelViewMatrix( modelView.get( ), osg::Transform::ABSOLUTE_RF );
+
+    for( unsigned int i = 0; i < camera->getNumChildren( ); ++i )
+        camera->getChild( i )->accept( cv );
+
+    cv.popModelViewMatrix( );
+    cv.popProjectionMatrix( );
+    cv.popViewport( );
+
+    // Only the requests are of interest, not what would be drawn
+    cv.setDatabaseRequestHandler( 0 );
+    _renderStage->reset( );
+    _stateGraph->clean( );
+    _stateGraph->prune( );
+}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "horizonCullVisitor.h"
+
+#include <osg/Viewport>
+#include <osgDB/DatabasePager>
+#include <osgUtil/RenderStage>
+#include <osgUtil/StateGraph>
+#include <osgViewer/View>
+
+namespace eqEarth
+{
+/**
+ * Culls the scene of an OSG view from where the camera is heading, so that
+ * its pager loads the tiles needed there while the camera gets there. The
+ * requests rank below those of the frame being drawn and are dropped as
+ * soon as they are not renewed, i.e. the camera turns elsewhere.
+ */
+class Prefetcher
+{
+public:
+    Prefetcher( );
+    ~Prefetcher( );
+
+    /** Issue the pager requests of a cull with this view matrix. */
+    void prefetch( osgViewer::View* osgView, const osg::Matrixd& viewMatrix,
+        const osg::FrameStamp* frameStamp );
+
+private:
+    class RequestHandler : public osg::NodeVisitor::DatabaseRequestHandler
+    {
+    public:
+        void setPager( osgDB::DatabasePager* pager ) { _pager = pager; }
+
+        virtual void requestNodeFile( const std::string& fileName,
+            osg::NodePath& nodePath, float priority,
+            const osg::FrameStamp* frameStamp,
+            osg::ref_ptr< osg::Referenced >& databaseRequest,
+            const osg::Referenced* options );
+
+    private:
+        osg::ref_ptr< osgDB::DatabasePager > _pager;
+    };
+
+    osg::ref_ptr< HorizonCullVisitor > _cullVisitor;
+    osg::ref_ptr< osgUtil::StateGraph > _stateGraph;
+    osg::ref_ptr< osgUtil::RenderStage > _renderStage;
+    osg::ref_ptr< osg::Viewport > _viewport;
+    osg::ref_ptr< RequestHandler > _requestHandler;
+};
+}
@@ -0,0 +1,104 @@
+#include "rangeCullVisitor.h"
+
+#include <osg/Geode>
+
+#include <algorithm>
+#include <cmath>
+
+// 256x256 cells of a few pixels each, fine enough to balance any view and
+// coarse enough to keep the patches of a source compact
+#define RANGE_LEVEL 8
+
+namespace eqEarth
+{
+// ----------------------------------------------------------------------------
+
+// Interleaves the bits of the column and row index, neighboring cells along
+// the curve are neighbors in the view
+static uint32_t _getMortonCode( const uint32_t x, const uint32_t y )
+{
+    uint32_t code = 0;
+    for( uint32_t i = 0; i < RANGE_LEVEL; ++i )
+        code |= (( x >> i ) & 1u ) << ( 2 * i ) |
+            (( y >> i ) & 1u ) << ( 2 * i + 1 );
+    return code;
+}
+
+// The cell of a normalized device coordinate, also of centers off the view
+static uint32_t _getCell( const double ndc )
+{
+    const uint32_t n = 1u << RANGE_LEVEL;
+    const double t = ( std::min( std::max( ndc, -1. ), 1. ) + 1. ) * .5;
+    return std::min( n - 1, static_cast< uint32_t >( t * n ));
+}
+
+RangeCullVisitor::RangeCullVisitor( )
+    : HorizonCullVisitor( )
+    , _start( 0.f )
+    , _end( 1.f )
+    , _numRangeCulled( 0 )
+{
+}
+
+RangeCullVisitor::RangeCullVisitor( const RangeCullVisitor& rhs )
+    : HorizonCullVisitor( rhs )
+    , _start( rhs._start )
+    , _end( rhs._end )
+    , _numRangeCulled( 0 )
+{
+}
+
+void RangeCullVisitor::setRange( const float start, const float end )
+{
+    _start = start;
+    _end = end;
+}
+
+void RangeCullVisitor::resetCounters( )
+{
+    HorizonCullVisitor::resetCounters( );
+    _numRangeCulled = 0;
+}
+
+// Groups, transforms and LODs are traversed by all sources, which then
+// agree on the leaves they reach
+void RangeCullVisitor::apply( osg::Geode& node )
+{
+    if( isInRange( node ))
+        HorizonCullVisitor::apply( node );
+    else if( !isCulled( node )) // only count what the frustum would keep
+        ++_numRangeCulled;
+}
+
+bool RangeCullVisitor::isInRange( osg::Node& node )
+{
+    // all of it
+    if( _start <= 0.f && _end >= 1.f )
+        return true;
+
+    // Passes of nested cameras, e.g. draped overlays, are drawn whole by
+    // every source, their model view is not in the main eye space
+    if( isInNestedCamera( ))
+        return true;
+
+    // e.g. the sky, drawn by everyone
+    if( !node.isCullingActive( ))
+        return true;
+
+    const osg::BoundingSphere& bs = node.getBound( );
+    if( !bs.valid( ))
+        return true;
+
+    // All sources of a DB compound share the frustum of the destination,
+    // so they all put a leaf into the same cell
+    const osg::Vec4d clip = osg::Vec4d( bs.center( ), 1. ) *
+        *getModelViewMatrix( ) * *getProjectionMatrix( );
+    const double w = std::max( std::abs( clip.w( )), 1e-9 );
+
+    const uint32_t n = 1u << RANGE_LEVEL;
+    const float key = float( _getMortonCode( _getCell( clip.x( ) / w ),
+        _getCell( clip.y( ) / w ))) / float( n * n );
+
+    return key >= _start && key < _end;
+}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "horizonCullVisitor.h"
+
+namespace eqEarth
+{
+/**
+ * Cull visitor for sort-last DB decompositions. The view is cut into a grid
+ * of cells ordered along a Morton curve, and the channel range selects a
+ * contiguous run of cells, i.e. a few compact patches of the view. The
+ * leaves, i.e. terrain tiles and features, go with the cell of their center
+ * and are drawn by exactly one source channel, so that a regional view
+ * splits as well as the whole globe. The destination composites the sources
+ * by depth.
+ */
+class RangeCullVisitor : public HorizonCullVisitor
+{
+public:
+    RangeCullVisitor( );
+    RangeCullVisitor( const RangeCullVisitor& rhs );
+
+    META_NodeVisitor( eqEarth, RangeCullVisitor )
+
+    virtual osgUtil::CullVisitor* clone( ) const
+        { return new RangeCullVisitor( *this ); }
+
+    /** The share of the view of the next cull, [0,1] draws all. */
+    void setRange( const float start, const float end );
+
+    virtual void apply( osg::Geode& node );
+
+    /** @return the leaves left to the other source channels. */
+    uint32_t getNumRangeCulled( ) const { return _numRangeCulled; }
+    virtual void resetCounters( );
+
+private:
+    float _start;
+    float _end;
+
+    uint32_t _numRangeCulled;
+
+    bool isInRange( osg::Node& node );
+};
+}
@@ -4,12 +4,21 @@
 #include <osgViewer/View>
 #include <osgDB/DatabasePager>
 
+#include <lunchbox/clock.h>
+#include <lunchbox/debug.h>
+
 namespace eqEarth
 {
 // ----------------------------------------------------------------------------
 
 Renderer::Renderer( osg::Camera* camera )
     : osgViewer::Renderer( camera )
+    , _numCulled( 0 )
+    , _cullTime( 0.f )
+    , _drawTime( 0.f )
+    , _numHorizonTiles( 0 )
+    , _numHorizonNodes( 0 )
+    , _numRangeCulled( 0 )
 {
     _availableQueue.takeFront( );
     _availableQueue.takeFront( );
@@ -56,6 +65,11 @@ Renderer::Renderer( osg::Camera* camera )
     _sceneView[0]->setDefaults( SceneView::COMPILE_GLOBJECTS_AT_INIT );
     _sceneView[1]->setDefaults( SceneView::COMPILE_GLOBJECTS_AT_INIT );
 
+    _cullVisitor[0] = new RangeCullVisitor;
+    _cullVisitor[1] = new RangeCullVisitor;
+    _sceneView[0]->setCullVisitor( _cullVisitor[0] );
+    _sceneView[1]->setCullVisitor( _cullVisitor[1] );
+
     _sceneView[0]->setDisplaySettings( ds );
     _sceneView[1]->setDisplaySettings( ds );
 
@@ -73,4 +87,60 @@ void Renderer::operator( )( osg::GraphicsContext* context )
     // cull/draw are called manually, don't let GraphicsContext::runOperations
     // (called in Window::frameFinish) run them
 }
+
+void Renderer::cull( )
+{
+    // The SceneView being drawn meanwhile does not touch its visitor
+    _cullVisitor[0]->resetCounters( );
+    _cullVisitor[1]->resetCounters( );
+
+    const lunchbox::Clock clock;
+    osgViewer::Renderer::cull( );
+    _cullTime = clock.getTimef( );
+
+    _numHorizonTiles = _cullVisitor[0]->getNumCulledTiles( ) +
+        _cullVisitor[1]->getNumCulledTiles( );
+    _numHorizonNodes = _cullVisitor[0]->getNumCulledNodes( ) +
+        _cullVisitor[1]->getNumCulledNodes( );
+    _numRangeCulled = _cullVisitor[0]->getNumRangeCulled( ) +
+        _cullVisitor[1]->getNumRangeCulled( );
+
+    if( !_done && !_graphicsThreadDoesCull )
+        ++_numCulled;
+}
+
+void Renderer::draw( )
+{
+    LBASSERT( _numCulled > 0 );
+
+    const lunchbox::Clock clock;
+    osgViewer::Renderer::draw( );
+    _drawTime = clock.getTimef( );
+
+    if( !_done )
+        --_numCulled;
+}
+
+void Renderer::setHorizonRadius( const double radius )
+{
+    _cullVisitor[0]->setRadius( radius );
+    _cullVisitor[1]->setRadius( radius );
+}
+
+void Renderer::setRange( const float start, const float end )
+{
+    _cullVisitor[0]->setRange( start, end );
+    _cullVisitor[1]->setRange( start, end );
+}
+
+void Renderer::discardCulled( )
+{
+    while( _numCulled > 0 )
+    {
+        osgUtil::SceneView* sceneView = _drawQueue.takeFront( );
+        if( sceneView )
+            _availableQueue.add( sceneView );
+        --_numCulled;
+    }
+}
 }
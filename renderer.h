@@ -2,6 +2,10 @@
 
 #include <osgViewer/Renderer>
 
+#include "rangeCullVisitor.h"
+
+#include <lunchbox/atomic.h>
+
 namespace eqEarth
 {
 class Renderer : public osgViewer::Renderer
@@ -10,5 +14,41 @@ public:
     Renderer( osg::Camera* camera );
 
     virtual void operator( )( osg::GraphicsContext* context );
+
+    virtual void cull( );
+    virtual void draw( );
+
+    /** @return the number of culled SceneViews waiting to be drawn. */
+    int32_t getNumCulled( ) const { return _numCulled; }
+
+    /** Drop all culled SceneViews, no cull may be in progress. */
+    void discardCulled( );
+
+    /** @return the duration of the last cull and draw in ms. */
+    float getCullTime( ) const { return _cullTime; }
+    float getDrawTime( ) const { return _drawTime; }
+
+    /** Cull behind the horizon of a globe, 0 for no globe. */
+    void setHorizonRadius( const double radius );
+
+    /** @return the tiles and other nodes the last cull found behind it. */
+    uint32_t getNumHorizonCulledTiles( ) const { return _numHorizonTiles; }
+    uint32_t getNumHorizonCulledNodes( ) const { return _numHorizonNodes; }
+
+    /** Draw only this share of the view, for DB decompositions. */
+    void setRange( const float start, const float end );
+
+    /** @return the leaves the last cull left to other channels. */
+    uint32_t getNumRangeCulled( ) const { return _numRangeCulled; }
+
+private:
+    lunchbox::a_int32_t _numCulled;
+    float _cullTime;
+    float _drawTime;
+    uint32_t _numHorizonTiles;
+    uint32_t _numHorizonNodes;
+    uint32_t _numRangeCulled;
+
+    osg::ref_ptr< RangeCullVisitor > _cullVisitor[2]; // one per SceneView
 };
 }
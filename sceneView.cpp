@@ -1,5 +1,7 @@
 #include "sceneView.h"
 
+#include "horizonCullVisitor.h"
+
 using namespace osg;
 using namespace osgUtil;
 
@@ -7,6 +9,39 @@ namespace eqEarth
 {
 // ----------------------------------------------------------------------------
 
+void SceneView::cull( )
+{
+    // With pipelined cull/draw the camera is already set up for the next
+    // frame when this SceneView gets drawn, keep what draw( ) needs.
+    _cullViewMatrix = getViewMatrix( );
+
+    const osg::Viewport* viewport = getViewport( );
+    if( viewport )
+    {
+        if( !_cullViewport.valid( ))
+            _cullViewport = new osg::Viewport;
+        _cullViewport->setViewport( viewport->x( ), viewport->y( ),
+            viewport->width( ), viewport->height( ));
+    }
+
+    const osg::ColorMask* colorMask = _camera->getColorMask( );
+    if( colorMask )
+    {
+        if( !_cullColorMask.valid( ))
+            _cullColorMask = new osg::ColorMask;
+        _cullColorMask->setMask( colorMask->getRedMask( ),
+            colorMask->getGreenMask( ), colorMask->getBlueMask( ),
+            colorMask->getAlphaMask( ));
+    }
+
+    HorizonCullVisitor* cullVisitor =
+        dynamic_cast< HorizonCullVisitor* >( getCullVisitor( ));
+    if( cullVisitor )
+        cullVisitor->setViewMatrix( _cullViewMatrix );
+
+    osgUtil::SceneView::cull( );
+}
+
 void SceneView::draw( )
 {
     if( _camera->getNodeMask( ) == 0 )
@@ -42,7 +77,7 @@ void SceneView::draw( )
     // that need flushing in the next frame.
     _requiresFlush = _automaticFlush;
 
-    state->setInitialViewMatrix( new RefMatrix( getViewMatrix( )));
+    state->setInitialViewMatrix( new RefMatrix( _cullViewMatrix ));
 
     RenderLeaf* previous = NULL;
 
@@ -57,11 +92,11 @@ void SceneView::draw( )
         _renderStage->setReadBuffer( _camera->getReadBuffer( ));
     }
 
-    _localStateSet->setAttribute( getViewport( ));
+    _localStateSet->setAttribute( _cullViewport.get( ));
 
-    _localStateSet->setAttribute( _camera->getColorMask( ));
+    _localStateSet->setAttribute( _cullColorMask.get( ));
 
-    _renderStage->setColorMask( _camera->getColorMask( ));
+    _renderStage->setColorMask( _cullColorMask.get( ));
 
     // bog standard draw.
     _renderStage->drawPreRenderStages( _renderInfo, previous );
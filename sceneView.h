@@ -7,6 +7,13 @@ namespace eqEarth
 class SceneView : public osgUtil::SceneView
 {
 protected:
+    virtual void cull();
     virtual void draw();
+
+private:
+    // per-pass camera state captured by cull, used by draw
+    osg::Matrixd _cullViewMatrix;
+    osg::ref_ptr< osg::Viewport > _cullViewport;
+    osg::ref_ptr< osg::ColorMask > _cullColorMask;
 };
 }
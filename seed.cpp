@@ -0,0 +1,317 @@
+// Seeds the tile cache of an .earth file around the sites of vps.h, or of a
+// file with one "lon lat" pair per line, from level 0 down to a maximum
+// level, fetching tiles with parallel workers. Uses the cache of the map,
+// the one in OSGEARTH_CACHE_PATH as eqEarth does, or a filesystem cache in
+// --cache <dir>.
+
+#include "vps.h"
+
+#include <lunchbox/atomic.h>
+#include <lunchbox/clock.h>
+#include <lunchbox/log.h>
+#include <lunchbox/mtQueue.h>
+#include <lunchbox/thread.h>
+
+#include <osgDB/ReadFile>
+#include <osgEarth/Cache>
+#include <osgEarth/MapNode>
+#include <osgEarth/Registry>
+#include <osgEarthDrivers/cache_filesystem/FileSystemCache>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+#define SEED_MAX_LEVEL 12
+#define SEED_RADIUS 20.0 // km around each site
+#define SEED_THREADS 8
+#define SEED_REPORT_TILES 1000
+
+#define EARTH_RADIUS 6371e3
+
+using namespace osgEarth;
+
+struct Site
+{
+    double lon, lat;
+};
+typedef std::vector< Site > Sites;
+
+static lunchbox::a_int32_t _numFetched( 0 );
+static lunchbox::a_int32_t _numSeeded( 0 ); // layer tiles with data
+static lunchbox::a_int32_t _numSkipped( 0 ); // without, e.g. off its extent
+
+// Fetches the tiles of all layers for the keys in the queue, a 0 key stops
+class Fetcher : public lunchbox::Thread
+{
+public:
+    Fetcher( lunchbox::MTQueue< const TileKey* >& queue, const Map* map )
+        : _queue( queue )
+    {
+        map->getImageLayers( _imageLayers );
+        map->getElevationLayers( _elevationLayers );
+    }
+
+protected:
+    virtual void run( )
+    {
+        for( ;; )
+        {
+            const TileKey* key = _queue.pop( );
+            if( !key )
+                break;
+
+            // A source without data for a valid key, e.g. a TMS set that
+            // only covers some regions, is not an error
+            for( ImageLayerVector::const_iterator i = _imageLayers.begin( );
+                 i != _imageLayers.end( ); ++i )
+            {
+                if(( *i )->isKeyValid( *key ))
+                    count(( *i )->createImage( *key ).valid( ));
+            }
+            for( ElevationLayerVector::const_iterator i =
+                     _elevationLayers.begin( );
+                 i != _elevationLayers.end( ); ++i )
+            {
+                if(( *i )->isKeyValid( *key ))
+                    count(( *i )->createHeightField( *key ).valid( ));
+            }
+
+            if( ++_numFetched % SEED_REPORT_TILES == 0 )
+                LBINFO << int32_t( _numFetched ) << " tiles" << std::endl;
+        }
+    }
+
+private:
+    lunchbox::MTQueue< const TileKey* >& _queue;
+
+    static void count( const bool valid )
+    {
+        if( valid )
+            ++_numSeeded;
+        else
+            ++_numSkipped;
+    }
+
+    ImageLayerVector _imageLayers;
+    ElevationLayerVector _elevationLayers;
+};
+
+// e.g. "0-9,12", same as --bench
+static bool addViewpoints( const std::string& viewpoints, Sites& sites )
+{
+    std::vector< uint32_t > indices;
+    if( !parseViewpoints( viewpoints, indices ))
+        return false;
+
+    for( size_t i = 0; i < indices.size( ); ++i )
+    {
+        const Site site = { VPs[ indices[i]].x( ), VPs[ indices[i]].y( ) };
+        sites.push_back( site );
+    }
+    return true;
+}
+
+static bool readSites( const std::string& fileName, Sites& sites )
+{
+    std::ifstream file( fileName.c_str( ));
+    if( !file )
+    {
+        LBERROR << "Cannot read sites from " << fileName << std::endl;
+        return false;
+    }
+
+    std::string line;
+    while( std::getline( file, line ))
+    {
+        Site site;
+        if( line.empty( ) || line[0] == '#' )
+            continue;
+        if( sscanf( line.c_str( ), "%lf %lf", &site.lon, &site.lat ) != 2 )
+        {
+            LBERROR << "Invalid site " << line << std::endl;
+            return false;
+        }
+        sites.push_back( site );
+    }
+    return true;
+}
+
+// The keys of all levels within radius km of a site
+static void addKeys( const Profile* profile, const Site& site,
+    const uint32_t maxLevel, const double radius, std::set< TileKey >& keys )
+{
+    const double dLat = osg::RadiansToDegrees( radius * 1000. / EARTH_RADIUS );
+    const double dLon = dLat / std::max( cos( osg::DegreesToRadians(
+        site.lat )), 0.01 );
+
+    const GeoExtent extent = GeoExtent( profile->getSRS( )->getGeographicSRS( ),
+        site.lon - dLon, std::max( site.lat - dLat, -90. ),
+        site.lon + dLon, std::min( site.lat + dLat, 90. )).transform(
+            profile->getSRS( ));
+    const GeoExtent& bounds = profile->getExtent( );
+
+    for( uint32_t level = 0; level <= maxLevel; ++level )
+    {
+        unsigned int numX, numY;
+        profile->getNumTiles( level, numX, numY );
+        const double w = bounds.width( ) / numX;
+        const double h = bounds.height( ) / numY;
+
+        // tile rows count from the north
+        const int x0 = int( floor(( extent.xMin( ) - bounds.xMin( )) / w ));
+        const int x1 = int( floor(( extent.xMax( ) - bounds.xMin( )) / w ));
+        const int y0 = int( floor(( bounds.yMax( ) - extent.yMax( )) / h ));
+        const int y1 = int( floor(( bounds.yMax( ) - extent.yMin( )) / h ));
+
+        for( int y = std::max( y0, 0 ); y <= std::min( y1, int( numY ) - 1 );
+             ++y )
+            for( int x = std::max( x0, 0 );
+                 x <= std::min( x1, int( numX ) - 1 ); ++x )
+                keys.insert( TileKey( level, x, y, profile ));
+    }
+}
+
+static void usage( const char* name )
+{
+    std::cerr << "Usage: " << name << " [--cache <dir>] [--max-level <n>]"
+        << " [--radius <km>] [--threads <n>]" << std::endl
+        << "    [--viewpoints <list> | --sites <file>] <file.earth>"
+        << std::endl;
+}
+
+int main( const int argc, char** argv )
+{
+    std::string cacheDir, earthFile, viewpoints, sitesFile;
+    uint32_t maxLevel = SEED_MAX_LEVEL;
+    double radius = SEED_RADIUS;
+    uint32_t numThreads = SEED_THREADS;
+
+    for( int i = 1; i < argc; ++i )
+    {
+        const std::string arg = argv[i];
+        const bool hasValue = ( i + 1 < argc );
+
+        if( arg == "--cache" && hasValue )
+            cacheDir = argv[++i];
+        else if( arg == "--max-level" && hasValue )
+            maxLevel = atoi( argv[++i] );
+        else if( arg == "--radius" && hasValue )
+            radius = atof( argv[++i] );
+        else if( arg == "--threads" && hasValue )
+            numThreads = std::max( atoi( argv[++i] ), 1 );
+        else if( arg == "--viewpoints" && hasValue )
+            viewpoints = argv[++i];
+        else if( arg == "--sites" && hasValue )
+            sitesFile = argv[++i];
+        else if( arg[0] != '-' && earthFile.empty( ))
+            earthFile = arg;
+        else
+        {
+            usage( argv[0] );
+            return EXIT_FAILURE;
+        }
+    }
+    if( earthFile.empty( ))
+    {
+        usage( argv[0] );
+        return EXIT_FAILURE;
+    }
+
+    Sites sites;
+    if( !sitesFile.empty( ))
+    {
+        if( !readSites( sitesFile, sites ))
+            return EXIT_FAILURE;
+    }
+    else
+    {
+        const uint32_t numVPs = sizeof( VPs ) / sizeof( VPs[0] );
+        std::ostringstream all;
+        all << "0-" << numVPs - 1;
+        if( !addViewpoints( viewpoints.empty( ) ? all.str( ) : viewpoints,
+                sites ))
+            return EXIT_FAILURE;
+    }
+
+    // Seed whatever the map's cache policy says
+    Registry::instance( )->setOverrideCachePolicy(
+        CachePolicy::USAGE_READ_WRITE );
+
+    osg::ref_ptr< osg::Node > node = osgDB::readNodeFile( earthFile );
+    MapNode* mapNode = MapNode::findMapNode( node.get( ));
+    if( !mapNode )
+    {
+        LBERROR << "No map in " << earthFile << std::endl;
+        return EXIT_FAILURE;
+    }
+    Map* map = mapNode->getMap( );
+
+    if( !cacheDir.empty( ))
+    {
+        Drivers::FileSystemCacheOptions options;
+        options.rootPath( ) = cacheDir;
+        osg::ref_ptr< Cache > cache = CacheFactory::create( options );
+        map->setCache( cache.get( ));
+
+        ImageLayerVector imageLayers;
+        map->getImageLayers( imageLayers );
+        for( size_t i = 0; i < imageLayers.size( ); ++i )
+            imageLayers[i]->setCache( cache.get( ));
+
+        ElevationLayerVector elevationLayers;
+        map->getElevationLayers( elevationLayers );
+        for( size_t i = 0; i < elevationLayers.size( ); ++i )
+            elevationLayers[i]->setCache( cache.get( ));
+    }
+    if( !map->getCache( ))
+    {
+        LBERROR << earthFile << " has no cache, set OSGEARTH_CACHE_PATH or"
+            << " use --cache <dir>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::set< TileKey > keys;
+    for( size_t i = 0; i < sites.size( ); ++i )
+        addKeys( map->getProfile( ), sites[i], maxLevel, radius, keys );
+
+    LBINFO << "Seeding " << keys.size( ) << " tiles around " << sites.size( )
+        << " sites to level " << maxLevel << " with " << numThreads
+        << " threads" << std::endl;
+
+    lunchbox::Clock clock;
+    lunchbox::MTQueue< const TileKey* > queue;
+    std::vector< Fetcher* > fetchers;
+    for( uint32_t i = 0; i < numThreads; ++i )
+    {
+        fetchers.push_back( new Fetcher( queue, map ));
+        fetchers.back( )->start( );
+    }
+
+    for( std::set< TileKey >::const_iterator i = keys.begin( );
+         i != keys.end( ); ++i )
+    {
+        queue.push( &*i );
+    }
+    for( uint32_t i = 0; i < numThreads; ++i )
+        queue.push( 0 );
+
+    for( uint32_t i = 0; i < numThreads; ++i )
+    {
+        fetchers[i]->join( );
+        delete fetchers[i];
+    }
+
+    const float seconds = clock.getTimef( ) / 1000.f;
+    std::cout << int32_t( _numFetched ) << " tiles, " << int32_t( _numSeeded )
+        << " layer tiles seeded, " << int32_t( _numSkipped )
+        << " without data, in " << seconds << " s, "
+        << int32_t( _numFetched ) / std::max( seconds, 0.001f ) << " tiles/s"
+        << std::endl;
+
+    // nothing at all is a wrong map or an unreachable server
+    return ( _numSeeded == 0 && !keys.empty( )) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,137 @@
+#include "trace.h"
+
+#include <lunchbox/perThread.h>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+
+#define RING_SIZE 65536 // events per thread, oldest are overwritten
+
+namespace eqEarth
+{
+// ----------------------------------------------------------------------------
+
+struct TraceEvent
+{
+    const char* name;
+    uint32_t frameNumber;
+    double start;
+    double duration;
+};
+
+// Only written by its own thread, read by Trace::write once tracing stopped
+struct TraceRing
+{
+    TraceRing( const uint32_t tid_ )
+        : events( RING_SIZE )
+        , numEvents( 0 )
+        , tid( tid_ ) { }
+
+    std::vector< TraceEvent > events;
+    uint64_t numEvents;
+    const uint32_t tid;
+};
+
+static lunchbox::Lock _lock; // protects _rings and _fileName
+static std::vector< TraceRing* > _rings;
+static std::string _fileName;
+
+// rings are kept after their thread exited until written
+static lunchbox::PerThread< TraceRing,
+    lunchbox::perThreadNoDelete< TraceRing > > _ring;
+
+static lunchbox::Clock _clock;
+static double _offset = 0.;
+
+bool Trace::_enabled = false;
+
+void Trace::enable( const std::string& fileName, const int64_t configTime )
+{
+    lunchbox::ScopedWrite _mutex( _lock );
+
+    if( _enabled || !_fileName.empty( ))
+        return;
+
+    _fileName = fileName;
+    _offset = static_cast< double >( configTime ) * 1000. -
+        _clock.getTimed( ) * 1000.;
+    _enabled = true;
+
+    LBINFO << "Tracing to " << _fileName << "." << getpid( ) << ".json"
+        << std::endl;
+}
+
+double Trace::now( )
+{
+    return _clock.getTimed( ) * 1000. + _offset;
+}
+
+void Trace::record( const char* name, const uint32_t frameNumber,
+        const double start, const double duration )
+{
+    TraceRing* ring = _ring.get( );
+    if( !ring )
+    {
+        lunchbox::ScopedWrite _mutex( _lock );
+        ring = new TraceRing( _rings.size( ));
+        _rings.push_back( ring );
+        _ring = ring;
+    }
+
+    TraceEvent& event = ring->events[ ring->numEvents++ % RING_SIZE ];
+    event.name = name;
+    event.frameNumber = frameNumber;
+    event.start = start;
+    event.duration = duration;
+}
+
+void Trace::write( )
+{
+    lunchbox::ScopedWrite _mutex( _lock );
+
+    if( !_enabled )
+        return;
+    _enabled = false;
+
+    std::ostringstream fileName;
+    fileName << _fileName << "." << getpid( ) << ".json";
+
+    std::ofstream file( fileName.str( ).c_str( ));
+    if( !file )
+    {
+        LBWARN << "Unable to write trace " << fileName.str( ) << std::endl;
+        return;
+    }
+
+    file << "{\"traceEvents\":[" << std::endl << std::fixed
+        << std::setprecision( 3 );
+
+    bool first = true;
+    for( std::vector< TraceRing* >::const_iterator i = _rings.begin( );
+            i != _rings.end( ); ++i )
+    {
+        const TraceRing* ring = *i;
+        const uint64_t end = ring->numEvents;
+        const uint64_t begin = ( end > RING_SIZE ) ? ( end - RING_SIZE ) : 0;
+
+        for( uint64_t j = begin; j < end; ++j )
+        {
+            const TraceEvent& event = ring->events[ j % RING_SIZE ];
+
+            file << ( first ? "" : ",\n" ) << "{\"name\":\"" << event.name
+                << "\",\"ph\":\"X\",\"pid\":" << getpid( )
+                << ",\"tid\":" << ring->tid
+                << ",\"ts\":" << event.start
+                << ",\"dur\":" << event.duration
+                << ",\"args\":{\"frame\":" << event.frameNumber << "}}";
+            first = false;
+        }
+    }
+
+    file << std::endl << "]}" << std::endl;
+
+    LBINFO << "Wrote trace " << fileName.str( ) << std::endl;
+}
+}
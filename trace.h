@@ -0,0 +1,60 @@
+#pragma once
+
+#include <eq/eq.h>
+
+// Frame tracing is compiled in with -DEQEARTH_TRACE and switched on at run
+// time with --trace. Without EQEARTH_TRACE the macros expand to nothing and
+// their arguments are not evaluated.
+#ifdef EQEARTH_TRACE
+#  define EQEARTH_TRACE_SCOPE( name, frameNumber ) \
+    eqEarth::Trace::Scope _traceScope( name, frameNumber )
+#else
+#  define EQEARTH_TRACE_SCOPE( name, frameNumber )
+#endif
+
+namespace eqEarth
+{
+/**
+ * Records complete events into a ring per thread, written as Chrome
+ * trace-event JSON (chrome://tracing) by each process on exit. Timestamps
+ * are in microseconds of config time, so the files of all nodes line up.
+ */
+class Trace
+{
+public:
+    class Scope
+    {
+    public:
+        // name must outlive the process, i.e. be a string literal
+        Scope( const char* name, const uint32_t frameNumber )
+            : _name( isEnabled( ) ? name : 0 )
+            , _frameNumber( frameNumber )
+            , _start( _name ? now( ) : 0. ) { }
+
+        ~Scope( )
+        {
+            if( _name )
+                record( _name, _frameNumber, _start, now( ) - _start );
+        }
+
+    private:
+        const char* const _name;
+        const uint32_t _frameNumber;
+        const double _start;
+    };
+
+    /** Start tracing, configTime being the current config time in ms. */
+    static void enable( const std::string& fileName, const int64_t configTime );
+    static bool isEnabled( ) { return _enabled; }
+
+    /** Stop tracing and write <fileName>.<pid>.json, once per process. */
+    static void write( );
+
+    static double now( );
+    static void record( const char* name, const uint32_t frameNumber,
+        const double start, const double duration );
+
+private:
+    static bool _enabled;
+};
+}
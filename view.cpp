@@ -9,11 +9,12 @@ View::View( eq::Layout* parent )
     , _proxy( this )
     , _sceneID( eq::UUID::ZERO )
     , _overlayID( eq::UUID::ZERO )
-    , _viewMatrix( eq::Matrix4f::IDENTITY )
-    , _near( 0.01 ), _far( 100.0 )
-    , _lat( 0.0 ), _lon( 0.0 )
+    , _slot( 0 )
+    , _frameData( 0 )
     , _origin( eq::Vector3f::ZERO )
     , _direction( eq::Vector3f::ZERO )
+    , _manipulator( 0 )
+    , _manipulatorGeneration( 0 )
 {
 LBINFO << "=====> View::View(" << (void *)this << ")" << std::endl;
 
@@ -47,40 +48,79 @@ void View::setOverlayID( const eq::uint128_t& id )
 
 void View::setViewMatrix( const eq::Matrix4f& viewMatrix )
 {
-    _viewMatrix = viewMatrix;
-    _proxy.setDirty( Proxy::DIRTY_CAMERA );
+    // Use what the render nodes get
+    _state.pose = Pose( viewMatrix );
+    _state.viewMatrix = _state.pose.getViewMatrix( );
 }
 
 void View::setNearFar( double near, double far )
 {
-    if(( near != _near ) || ( far != _far ))
-    {
-        _near = near;
-        _far = far;
-        _proxy.setDirty( Proxy::DIRTY_NEARFAR );
-    }
+    _state.near = near;
+    _state.far = far;
 }
 
 void View::getNearFar( double& near, double& far ) const
 {
-    near = _near;
-    far = _far;
+    const ViewState& state = getState( );
+    near = state.near;
+    far = state.far;
 }
 
 void View::setLatLon( double lat, double lon )
 {
-    if(( lat != _lat ) || ( lon != _lon ))
+    _state.lat = lat;
+    _state.lon = lon;
+}
+
+void View::getLatLon( double& lat, double& lon ) const
+{
+    const ViewState& state = getState( );
+    lat = state.lat;
+    lon = state.lon;
+}
+
+void View::setPrefetchMatrix( const eq::Matrix4f& viewMatrix )
+{
+    _state.prefetch = true;
+    _state.prefetchPose = Pose( viewMatrix );
+}
+
+void View::clearPrefetch( )
+{
+    _state.prefetch = false;
+}
+
+void View::setSlot( const uint32_t slot )
+{
+    if( slot != _slot )
     {
-        _lat = lat;
-        _lon = lon;
-        _proxy.setDirty( Proxy::DIRTY_LATLON );
+        _slot = slot;
+        _proxy.setDirty( Proxy::DIRTY_SLOT );
     }
 }
 
-void View::getLatLon( double& lat, double& lon ) const
+bool View::setManipulatorGeneration( const osgGA::CameraManipulator* m,
+        const uint32_t generation, const osg::Matrixd& viewMatrix )
+{
+    // the generation misses moves that bypass the eqEarth manipulator, e.g.
+    // calls through an osgEarth::Util::EarthManipulator pointer
+    if(( m == _manipulator ) && ( generation == _manipulatorGeneration ) &&
+        ( viewMatrix == _manipulatorMatrix ))
+    {
+        return false;
+    }
+
+    _manipulator = m;
+    _manipulatorGeneration = generation;
+    _manipulatorMatrix = viewMatrix;
+    return true;
+}
+
+const ViewState& View::getState( ) const
 {
-    lat = _lat;
-    lon = _lon;
+    if( _frameData && ( _slot < _frameData->getNumViewStates( )))
+        return _frameData->getViewState( _slot );
+    return _state;
 }
 
 void View::setWorldPointer( const eq::Vector3f& origin,
@@ -107,12 +147,8 @@ void View::Proxy::serialize( co::DataOStream& os, const uint64_t dirtyBits )
         os << _view->_sceneID;
     if( dirtyBits & DIRTY_OVERLAY )
         os << _view->_overlayID;
-    if( dirtyBits & DIRTY_CAMERA )
-        os << _view->_viewMatrix;
-    if( dirtyBits & DIRTY_NEARFAR )
-        os << _view->_near << _view->_far;
-    if( dirtyBits & DIRTY_LATLON )
-        os << _view->_lat << _view->_lon;
+    if( dirtyBits & DIRTY_SLOT )
+        os << _view->_slot;
     if( dirtyBits & DIRTY_POINTER )
         os << _view->_origin << _view->_direction;
 }
@@ -123,23 +159,11 @@ void View::Proxy::deserialize( co::DataIStream& is, const uint64_t dirtyBits )
         is >> _view->_sceneID;
     if( dirtyBits & DIRTY_OVERLAY )
         is >> _view->_overlayID;
-    if( dirtyBits & DIRTY_CAMERA )
-    {
-        is >> _view->_viewMatrix;
-        if( isMaster( ))
-            setDirty( DIRTY_CAMERA ); // redistribute
-    }
-    if( dirtyBits & DIRTY_NEARFAR )
-    {
-        is >> _view->_near >> _view->_far;
-        if( isMaster( ))
-            setDirty( DIRTY_NEARFAR ); // redistribute
-    }
-    if( dirtyBits & DIRTY_LATLON )
+    if( dirtyBits & DIRTY_SLOT )
     {
-        is >> _view->_lat >> _view->_lon;
+        is >> _view->_slot;
         if( isMaster( ))
-            setDirty( DIRTY_LATLON ); // redistribute
+            setDirty( DIRTY_SLOT ); // redistribute
     }
     if( dirtyBits & DIRTY_POINTER )
     {
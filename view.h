@@ -2,6 +2,8 @@
 
 #include <eq/eq.h>
 
+#include "frameData.h"
+
 #include <osgViewer/View>
 
 namespace eqEarth
@@ -21,8 +23,10 @@ public:
     void setOverlayID( const eq::uint128_t& id );
     eq::uint128_t getOverlayID( ) const { return _overlayID; }
 
+    // Distributed with the frame data as a Pose
     void setViewMatrix( const eq::Matrix4f& viewMatrix );
-    const eq::Matrix4f& getViewMatrix( ) const { return _viewMatrix; }
+    const eq::Matrix4f& getViewMatrix( ) const
+        { return getState( ).viewMatrix; }
 
     void setNearFar( double near, double far );
     void getNearFar( double& near, double& far ) const;
@@ -30,11 +34,35 @@ public:
     void setLatLon( double lat, double lon );
     void getLatLon( double& lat, double& lon ) const;
 
+    // Where the camera is heading, distributed like the view matrix and
+    // read by the nodes from the frame data view states
+    void setPrefetchMatrix( const eq::Matrix4f& viewMatrix );
+    void clearPrefetch( );
+
+    /** The slot of this view in the frame data view states. */
+    void setSlot( const uint32_t slot );
+    uint32_t getSlot( ) const { return _slot; }
+
+    /**
+     * Read the camera state from the view states of the given frame data
+     * from now on, instead of the state set on this instance.
+     */
+    void setFrameData( const FrameData* frameData )
+        { _frameData = frameData; }
+    const ViewState& getState( ) const;
+
     void setWorldPointer( const eq::Vector3f& origin,
         const eq::Vector3f& direction );
     void getWorldPointer( eq::Vector3f& origin, eq::Vector3f& direction ) const;
 
     // AppNode only
+    /**
+     * @return false if the manipulator is at the generation and view matrix
+     *         already.
+     */
+    bool setManipulatorGeneration( const osgGA::CameraManipulator* m,
+        const uint32_t generation, const osg::Matrixd& viewMatrix );
+
     void setOSGView( osgViewer::View* osgView ) { _osgView = osgView; }
     osgViewer::View* getOSGView( ) { return _osgView; }
     const osgViewer::View* getOSGView( ) const { return _osgView; }
@@ -51,9 +79,7 @@ private:
         {
             DIRTY_SCENE   = co::Serializable::DIRTY_CUSTOM << 0,
             DIRTY_OVERLAY = co::Serializable::DIRTY_CUSTOM << 1,
-            DIRTY_CAMERA  = co::Serializable::DIRTY_CUSTOM << 2,
-            DIRTY_NEARFAR = co::Serializable::DIRTY_CUSTOM << 3,
-            DIRTY_LATLON  = co::Serializable::DIRTY_CUSTOM << 4,
+            DIRTY_SLOT    = co::Serializable::DIRTY_CUSTOM << 2,
             DIRTY_POINTER = co::Serializable::DIRTY_CUSTOM << 5
         };
 
@@ -65,19 +91,21 @@ private:
 
     private:
         View* const _view;
-        friend class View;
     };
 
     Proxy _proxy;
     friend class Proxy;
     eq::uint128_t _sceneID;
     eq::uint128_t _overlayID;
-    eq::Matrix4f _viewMatrix;
-    double _near, _far;
-    double _lat, _lon;
+    uint32_t _slot;
+    ViewState _state;
+    const FrameData* _frameData;
     eq::Vector3f _origin;
     eq::Vector3f _direction;
 
     osg::ref_ptr< osgViewer::View > _osgView;
+    const osgGA::CameraManipulator* _manipulator;
+    uint32_t _manipulatorGeneration;
+    osg::Matrixd _manipulatorMatrix;
 };
 }
@@ -0,0 +1,199 @@
+// Cost of the per-frame view state on the application node for 1 to 256
+// views: all views in the frame data versus one proxy object per view as
+// before. Each commit is serialized into a stream that counts the bytes
+// instead of sending them, the same data a commit hands to Collage.
+
+#include "frameData.h"
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#define MAX_VIEWS 256
+#define NUM_FRAMES 1000
+
+using namespace eqEarth;
+
+// ----------------------------------------------------------------------------
+
+// Keeps the data written instead of sending it
+class CountingOStream : public co::DataOStream
+{
+public:
+    CountingOStream( )
+    {
+        _enable( );
+        enableSave( );
+    }
+
+    virtual ~CountingOStream( ) { disable( ); }
+
+    uint64_t getSize( ) { return getBuffer( ).getSize( ); }
+
+protected:
+    virtual void sendData( const void*, const uint64_t, const bool ) {}
+};
+
+// A serializable that tracks its own dirty bits, so that it can be
+// committed without a session
+template< class T > class Committable : public T
+{
+public:
+    Committable( ) : _dirty( co::Serializable::DIRTY_NONE ) {}
+
+    /** @return the bytes of a delta commit, 0 if there is nothing to send. */
+    uint64_t commitCounted( )
+    {
+        if( _dirty == co::Serializable::DIRTY_NONE )
+            return 0;
+
+        // dirty bits, then the data, as Serializable::pack
+        CountingOStream os;
+        os << _dirty;
+        this->serialize( os, _dirty );
+        _dirty = co::Serializable::DIRTY_NONE;
+        return os.getSize( );
+    }
+
+protected:
+    virtual void setDirty( const uint64_t bits ) { _dirty |= bits; }
+    virtual bool isDirty( ) const
+        { return _dirty != co::Serializable::DIRTY_NONE; }
+    virtual bool isDirty( const uint64_t bits ) const
+        { return ( _dirty & bits ) == bits; }
+
+private:
+    uint64_t _dirty;
+};
+
+// The per-view proxy the views had before the frame data carried them
+class ViewProxy : public co::Serializable
+{
+public:
+    void setState( const ViewState& state )
+    {
+        if( state.pose.position != _state.pose.position )
+            setDirty( DIRTY_POSITION );
+        if( !state.pose.hasOrientation( _state.pose ))
+            setDirty( DIRTY_ORIENTATION );
+        if( state.near != _state.near || state.far != _state.far )
+            setDirty( DIRTY_NEARFAR );
+        if( state.lat != _state.lat || state.lon != _state.lon )
+            setDirty( DIRTY_LATLON );
+        _state = state;
+    }
+
+protected:
+    enum DirtyBits
+    {
+        DIRTY_POSITION    = co::Serializable::DIRTY_CUSTOM << 0,
+        DIRTY_ORIENTATION = co::Serializable::DIRTY_CUSTOM << 1,
+        DIRTY_NEARFAR     = co::Serializable::DIRTY_CUSTOM << 2,
+        DIRTY_LATLON      = co::Serializable::DIRTY_CUSTOM << 3
+    };
+
+    virtual void serialize( co::DataOStream& os, const uint64_t dirtyBits )
+    {
+        const Pose& pose = _state.pose;
+        if( dirtyBits & DIRTY_POSITION )
+            os << pose.position;
+        if( dirtyBits & DIRTY_ORIENTATION )
+            os << pose.orientation[0] << pose.orientation[1]
+                << pose.orientation[2] << pose.orientation[3];
+        if( dirtyBits & DIRTY_NEARFAR )
+            os << _state.near << _state.far;
+        if( dirtyBits & DIRTY_LATLON )
+            os << _state.lat << _state.lon;
+    }
+
+private:
+    ViewState _state;
+};
+
+// ----------------------------------------------------------------------------
+
+// A camera per view circling at its own phase so that every view changes
+static eq::Matrix4f orbit( const uint32_t view, const uint32_t frame )
+{
+    const float a = 0.01f * frame + 0.1f * view;
+    const float c = cos( a ), s = sin( a );
+
+    eq::Matrix4f m( eq::Matrix4f::IDENTITY );
+    m( 0, 0 ) = c;  m( 0, 2 ) = -s;
+    m( 2, 0 ) = s;  m( 2, 2 ) = c;
+    m( 2, 3 ) = -1e7f;
+    return m;
+}
+
+int main( )
+{
+    std::cout << std::fixed << std::setprecision( 3 )
+        << "views   batched: us/frame  commits/frame  bytes/frame"
+        << "   per-view: us/frame  commits/frame  bytes/frame" << std::endl;
+
+    for( uint32_t numViews = 1; numViews <= MAX_VIEWS; numViews *= 2 )
+    {
+        ViewState state;
+
+        // all views with the frame data
+        Committable< FrameData > frameData;
+        uint64_t batchedCommits = 0, batchedBytes = 0;
+
+        lunchbox::Clock clock;
+        for( uint32_t frame = 0; frame < NUM_FRAMES; ++frame )
+        {
+            for( uint32_t i = 0; i < numViews; ++i )
+            {
+                state.pose = Pose( orbit( i, frame ));
+                frameData.setViewState( i, state );
+            }
+            frameData.setSimulationTime( frame );
+
+            const uint64_t bytes = frameData.commitCounted( );
+            batchedCommits += ( bytes > 0 );
+            batchedBytes += bytes;
+        }
+        const float batchedTime = clock.resetTimef( ) * 1000.f / NUM_FRAMES;
+
+        // one proxy per view, the frame data only carries the time
+        Committable< FrameData > timeData;
+        std::vector< Committable< ViewProxy >* > proxies;
+        for( uint32_t i = 0; i < numViews; ++i )
+            proxies.push_back( new Committable< ViewProxy > );
+        uint64_t perViewCommits = 0, perViewBytes = 0;
+
+        clock.reset( );
+        for( uint32_t frame = 0; frame < NUM_FRAMES; ++frame )
+        {
+            for( uint32_t i = 0; i < numViews; ++i )
+            {
+                state.pose = Pose( orbit( i, frame ));
+                proxies[ i ]->setState( state );
+
+                const uint64_t bytes = proxies[ i ]->commitCounted( );
+                perViewCommits += ( bytes > 0 );
+                perViewBytes += bytes;
+            }
+            timeData.setSimulationTime( frame );
+
+            const uint64_t bytes = timeData.commitCounted( );
+            perViewCommits += ( bytes > 0 );
+            perViewBytes += bytes;
+        }
+        const float perViewTime = clock.getTimef( ) * 1000.f / NUM_FRAMES;
+
+        for( uint32_t i = 0; i < numViews; ++i )
+            delete proxies[ i ];
+
+        std::cout << std::setw( 5 ) << numViews
+            << std::setw( 19 ) << batchedTime
+            << std::setw( 15 ) << float( batchedCommits ) / NUM_FRAMES
+            << std::setw( 13 ) << batchedBytes / NUM_FRAMES
+            << std::setw( 20 ) << perViewTime
+            << std::setw( 15 ) << float( perViewCommits ) / NUM_FRAMES
+            << std::setw( 13 ) << perViewBytes / NUM_FRAMES << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
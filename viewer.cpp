@@ -1,5 +1,6 @@
 #include "viewer.h"
 
+#include "earthManipulator.h"
 #include "renderer.h"
 #include "util.h"
 
@@ -7,10 +8,26 @@
 #include <osgViewer/View>
 #include <osg/DeleteHandler>
 
+#include <osgEarth/MapNode>
+
 namespace eqEarth
 {
 // ----------------------------------------------------------------------------
 
+SceneDescriptor::SceneDescriptor( )
+    : mapNode( 0 )
+    , geocentric( false )
+    , radiusEquator( 0. ), radiusPolar( 0. )
+    , srs( 0 )
+    , manipulator( MANIPULATOR_NONE )
+    , earthManipulator( 0 )
+    , sceneData( 0 )
+    , cameraManipulator( 0 )
+{
+}
+
+// ----------------------------------------------------------------------------
+
 class osgView : public osgViewer::View
 {
 public:
@@ -20,13 +37,52 @@ public:
 
     const eq::uint128_t& getID( ) const { return _id; }
 
+    const SceneDescriptor& getSceneDescriptor( );
+
 protected:
     osg::GraphicsOperation* createRenderer( osg::Camera* camera );
 
 private:
     const eq::uint128_t _id;
+    SceneDescriptor _descriptor;
 };
 
+const SceneDescriptor& osgView::getSceneDescriptor( )
+{
+    SceneDescriptor& d = _descriptor;
+
+    if( d.sceneData != getSceneData( ))
+    {
+        d.sceneData = getSceneData( );
+        d.mapNode = osgEarth::MapNode::findMapNode(
+            const_cast< osg::Node* >( d.sceneData ));
+        d.geocentric = d.mapNode && d.mapNode->isGeocentric( );
+        d.srs = d.mapNode ? d.mapNode->getMapSRS( ) : 0;
+        if( d.srs && d.srs->getEllipsoid( ))
+        {
+            d.radiusEquator = d.srs->getEllipsoid( )->getRadiusEquator( );
+            d.radiusPolar = d.srs->getEllipsoid( )->getRadiusPolar( );
+        }
+        else
+            d.radiusEquator = d.radiusPolar = 0.;
+    }
+
+    if( d.cameraManipulator != getCameraManipulator( ))
+    {
+        d.cameraManipulator = getCameraManipulator( );
+        d.earthManipulator =
+            dynamic_cast< EarthManipulator* >( getCameraManipulator( ));
+        if( d.earthManipulator )
+            d.manipulator = SceneDescriptor::MANIPULATOR_EARTH;
+        else if( d.cameraManipulator )
+            d.manipulator = SceneDescriptor::MANIPULATOR_OTHER;
+        else
+            d.manipulator = SceneDescriptor::MANIPULATOR_NONE;
+    }
+
+    return d;
+}
+
 osg::GraphicsOperation* osgView::createRenderer( osg::Camera* camera )
 {
     return new Renderer( camera );
@@ -58,18 +114,33 @@ osgViewer::View* CompositeViewer::createOSGView( const eq::uint128_t& id )
     return new osgView( id );
 }
 
+const SceneDescriptor& CompositeViewer::getSceneDescriptor(
+        osgViewer::View* view )
+{
+    return static_cast< osgView* >( view )->getSceneDescriptor( );
+}
+
 osgViewer::View* CompositeViewer::findOSGViewByID( const eq::uint128_t& id )
 {
-    Views views;
-    getViews( views );
+    ViewMap::const_iterator i = _viewMap.find( id );
+    return ( i != _viewMap.end( )) ? i->second : NULL;
+}
 
-    for( Views::iterator vitr = views.begin( ); vitr != views.end( ); ++vitr)
-    {
-        osg::ref_ptr< osgView > v = static_cast< osgView* >( *vitr );
-        if( v->getID( ) == id )
-            return v.get( );
-    }
-    return NULL;
+void CompositeViewer::addOSGView( osgViewer::View* view )
+{
+    osgViewer::CompositeViewer::addView( view );
+
+    _viewMap[ static_cast< osgView* >( view )->getID( )] = view;
+}
+
+void CompositeViewer::removeOSGView( osgViewer::View* view )
+{
+    ViewMap::iterator i =
+        _viewMap.find( static_cast< osgView* >( view )->getID( ));
+    if( i != _viewMap.end( ) && i->second == view )
+        _viewMap.erase( i );
+
+    osgViewer::CompositeViewer::removeView( view );
 }
 
 void CompositeViewer::advance( const uint32_t frameNumber,
@@ -104,17 +175,39 @@ void CompositeViewer::advance( const uint32_t frameNumber,
 }
 
 void CompositeViewer::frameStart( const uint32_t frameNumber,
-        const FrameData& frameData )
+        const FrameData& frameData, FrameStats* stats )
 {
 //LBINFO << "-----> Viewer::frameStart(" << frameNumber << ")" << std::endl;
 
     advance( frameNumber, frameData );
 
+    Scenes scenes;
+    getScenes( scenes );
+
+    lunchbox::Clock clock;
     eventTraversal( );
+
+    if( stats )
+        stats->add( FrameStats::STAGE_EVENT, clock.resetTimef( ));
+
+    // Merge paged subgraphs ahead of the update traversal, with or without
+    // stats, to time them apart. The update traversal then finds nothing
+    // left to merge.
+    for( Scenes::iterator sitr = scenes.begin( );
+            sitr != scenes.end( ); ++sitr)
+    {
+        osgDB::DatabasePager* dp = ( *sitr )->getDatabasePager( );
+        if( dp )
+            dp->updateSceneGraph( *getViewerFrameStamp( ));
+    }
+
+    if( stats )
+        stats->add( FrameStats::STAGE_PAGER_MERGE, clock.resetTimef( ));
+
     updateTraversal( );
 
-    Scenes scenes;
-    getScenes( scenes );
+    if( stats )
+        stats->add( FrameStats::STAGE_UPDATE, clock.getTimef( ));
 
     for( Scenes::iterator sitr = scenes.begin( );
             sitr != scenes.end( ); ++sitr)
@@ -4,9 +4,48 @@
 #include <osgViewer/CompositeViewer>
 
 #include "frameData.h"
+#include "frameStats.h"
+
+#include <lunchbox/stdExt.h>
+
+namespace osgEarth
+{
+class MapNode;
+class SpatialReference;
+}
 
 namespace eqEarth
 {
+class EarthManipulator;
+
+/**
+ * What the per-frame paths need to know about the scene of an OSG view.
+ * Refreshed when the scene data or the camera manipulator change.
+ */
+struct SceneDescriptor
+{
+    SceneDescriptor( );
+
+    enum Manipulator
+    {
+        MANIPULATOR_NONE,
+        MANIPULATOR_EARTH,
+        MANIPULATOR_OTHER
+    };
+
+    osgEarth::MapNode* mapNode;
+    bool geocentric;
+    double radiusEquator, radiusPolar;
+    const osgEarth::SpatialReference* srs;
+
+    Manipulator manipulator;
+    EarthManipulator* earthManipulator;
+
+    // what the above was computed from
+    const osg::Node* sceneData;
+    const osgGA::CameraManipulator* cameraManipulator;
+};
+
 class CompositeViewer : public osgViewer::CompositeViewer
 {
 public:
@@ -14,15 +53,25 @@ public:
     void setGlobalContext( osg::GraphicsContext *context );
 
     static osgViewer::View* createOSGView( const eq::uint128_t& id );
+    static const SceneDescriptor& getSceneDescriptor( osgViewer::View* view );
     osgViewer::View* findOSGViewByID( const eq::uint128_t& id );
 
+    /** addView/removeView that keep the ID index in sync, use these. */
+    void addOSGView( osgViewer::View* view );
+    void removeOSGView( osgViewer::View* view );
+
     void advance( const uint32_t frameNumber, const FrameData& frameData );
 
-    void frameStart( const uint32_t frameNumber, const FrameData& frameData );
+    void frameStart( const uint32_t frameNumber, const FrameData& frameData,
+        FrameStats* stats = 0 );
     void frameDrawFinish( );
 
     // AppNode only
     virtual void renderingTraversals( bool needMakeCurrentInThisThread );
     virtual void realize( );
+
+private:
+    typedef stde::hash_map< eq::uint128_t, osgViewer::View* > ViewMap;
+    ViewMap _viewMap; // views are ref'd by osgViewer::CompositeViewer
 };
 }
@@ -1,6 +1,11 @@
+#include <lunchbox/log.h>
 #include <osg/Vec3d>
 #include <osgEarth/Viewpoint>
 
+#include <cstdio>
+#include <sstream>
+#include <vector>
+
 static osgEarth::Viewpoint VPs[] =
 {
     osgEarth::Viewpoint( "FtDix", osg::Vec3d( -74.615666944444442, 39.997432777777782, 0 ), 0.0, -90, 1e3 ),
@@ -195,3 +200,34 @@ static osgEarth::Viewpoint VPs[] =
     osgEarth::Viewpoint( "Bangkok, TH", osg::Vec3d( 100.56035054686, 13.7783496561836, 0 ), 0.0, -90, 1e4 ),
     osgEarth::Viewpoint( "Barcelona, SP", osg::Vec3d( 2.13246973992958, 41.3645146681043, 0 ), 0.0, -90, 1e4 ),
 };
+
+// Indices into VPs from a list like "0-9,12", skips and warns about invalid
+// entries. @return false if there were any.
+static bool parseViewpoints( const std::string& list,
+        std::vector< uint32_t >& indices )
+{
+    const uint32_t numVPs = sizeof( VPs ) / sizeof( VPs[0] );
+    bool valid = true;
+
+    std::istringstream ranges( list );
+    std::string range;
+    while( std::getline( ranges, range, ',' ))
+    {
+        uint32_t first = 0, last = 0;
+        const int n = sscanf( range.c_str( ), "%u-%u", &first, &last );
+        if( n < 2 )
+            last = first;
+
+        if( n < 1 || first > last || last >= numVPs )
+        {
+            LBWARN << "Ignoring viewpoints " << range << ", " << numVPs
+                << " available" << std::endl;
+            valid = false;
+            continue;
+        }
+
+        for( uint32_t i = first; i <= last; ++i )
+            indices.push_back( i );
+    }
+    return valid;
+}
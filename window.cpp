@@ -1,5 +1,6 @@
 #include "window.h"
 #include "node.h"
+#include "trace.h"
 
 #include <osgEarth/Registry>
 
@@ -170,8 +171,7 @@ bool Window::configExitGL( )
 void Window::frameStart( const eq::uint128_t& frameID,
         const uint32_t frameNumber )
 {
-LBINFO << "-----> Window<" << getName( ) << ">::frameStart("
-    << frameID << ", " << frameNumber << ")" << std::endl;
+    EQEARTH_TRACE_SCOPE( "Window::frameStart", frameNumber );
 
     LBASSERT( _window.valid( ) && _window->valid( ));
 
@@ -182,28 +182,20 @@ LBINFO << "-----> Window<" << getName( ) << ">::frameStart("
     _window->runOperations( );
 
     eq::Window::frameStart( frameID, frameNumber );
-
-LBINFO << "<----- Window<" << getName( ) << ">::frameStart("
-    << frameID << ", " << frameNumber << ")" << std::endl;
 }
 
 void Window::frameFinish( const eq::uint128_t& frameID,
         const uint32_t frameNumber )
 {
-LBINFO << "-----> Window<" << getName( ) << ">::frameFinish("
-    << frameID << ", " << frameNumber << ")" << std::endl;
+    EQEARTH_TRACE_SCOPE( "Window::frameFinish", frameNumber );
 
     eq::Window::frameFinish( frameID, frameNumber );
-
-LBINFO << "<----- Window<" << getName( ) << ">::frameFinish("
-    << frameID << ", " << frameNumber << ")" << std::endl;
 }
 
 void Window::frameDrawFinish( const eq::uint128_t& frameID,
         const uint32_t frameNumber )
 {
-LBINFO << "-----> Window<" << getName( ) << ">::frameDrawFinish("
-    << frameID << ", " << frameNumber << ")" << std::endl;
+    EQEARTH_TRACE_SCOPE( "Window::frameDrawFinish", frameNumber );
 
     LBASSERT( _window.valid( ) && _window->valid( ));
 
@@ -211,18 +203,20 @@ LBINFO << "-----> Window<" << getName( ) << ">::frameDrawFinish("
     _window->releaseContext( );
 
     eq::Window::frameDrawFinish( frameID, frameNumber );
-
-LBINFO << "<----- Window<" << getName( ) << ">::frameDrawFinish("
-    << frameID << ", " << frameNumber << ")" << std::endl;
 }
 
 void Window::swapBuffers( )
 {
+    const lunchbox::Clock clock;
+
     if( _window.valid( ) && _window->valid( ))
         // Calls clear which ensures _lastClearTick is set for the pager
         _window->swapBuffers( );
 
     eq::Window::swapBuffers( );
+
+    static_cast< Node* >( getNode( ))->getStats( ).add(
+        FrameStats::STAGE_SWAP, clock.getTimef( ));
 }
 
 void Window::cleanup( )